@@ -0,0 +1,45 @@
+/**
+ * Throughput of the blinded version signatures, with and without BlindingContextNode.
+ * Run with `node bench/blinding.js [iterations]`, after building the addon for node.
+ */
+const crypto = require('crypto');
+const path = require('path');
+
+const { BlindingWrapperNode, BlindingContextNode } = require(path.join(__dirname, '..'));
+
+const iterations = Number(process.argv[2] || 2000);
+
+function secretKey() {
+  const { privateKey } = crypto.generateKeyPairSync('ed25519');
+  const jwk = privateKey.export({ format: 'jwk' });
+  return new Uint8Array(
+    Buffer.concat([Buffer.from(jwk.d, 'base64url'), Buffer.from(jwk.x, 'base64url')])
+  );
+}
+
+function bench(name, fn) {
+  fn(0); // warm up
+  const start = process.hrtime.bigint();
+  fn(iterations);
+  const ms = Number(process.hrtime.bigint() - start) / 1e6;
+  const perSecond = Math.round((iterations / ms) * 1000);
+  console.log(`${name.padEnd(40)} ${ms.toFixed(1).padStart(10)} ms ${perSecond} signatures/s`);
+}
+
+const ed25519SecretKey = secretKey();
+const now = Math.floor(Date.now() / 1000);
+const timestamps = Array.from({ length: iterations }, (_, i) => now + i);
+
+bench('BlindingWrapperNode.blindVersionSign', n => {
+  for (let i = 0; i < n; i++)
+    BlindingWrapperNode.blindVersionSign({ ed25519SecretKey, sigTimestampSeconds: now + i });
+});
+
+const context = new BlindingContextNode({ ed25519SecretKey });
+bench('BlindingContextNode.blindVersionSign', n => {
+  for (let i = 0; i < n; i++) context.blindVersionSign(now + i);
+});
+
+bench('BlindingContextNode.signMany', n => {
+  context.signMany(timestamps.slice(0, n));
+});
@@ -1,3 +1,56 @@
 var libsession_util_nodejs = require('./build/Release/libsession_util_nodejs.node');
+var Writable = require('stream').Writable;
+
+/**
+ * Returns an object mode Writable merging the `{hash, data}` messages written to it into `wrapper`
+ * (see `ingestStart`). Writes are held back while the wrapper has too much buffered, and the stream
+ * only finishes once everything was merged. It emits a 'merged' event with the hashes merged by
+ * each batch.
+ */
+libsession_util_nodejs.createMergeStream = function (wrapper, options) {
+  var pendingWrite = null;
+  var pendingFinal = null;
+
+  var stream = new Writable({
+    objectMode: true,
+    write: function (msg, _encoding, callback) {
+      try {
+        if (wrapper.ingest(msg.hash, msg.data)) callback();
+        else pendingWrite = callback;
+      } catch (e) {
+        callback(e);
+      }
+    },
+    final: function (callback) {
+      try {
+        if (wrapper.ingestEnd()) callback();
+        else pendingFinal = callback;
+      } catch (e) {
+        callback(e);
+      }
+    },
+  });
+
+  wrapper.ingestStart(function (event) {
+    if (event.merged.length) stream.emit('merged', event.merged);
+    var error = event.error ? new Error(event.error) : null;
+    if (error && !pendingWrite && !pendingFinal) {
+      stream.destroy(error);
+      return;
+    }
+    if (pendingWrite && (event.writable || error)) {
+      var write = pendingWrite;
+      pendingWrite = null;
+      write(error);
+    }
+    if (pendingFinal && (event.done || error)) {
+      var final = pendingFinal;
+      pendingFinal = null;
+      final(error);
+    }
+  }, options);
+
+  return stream;
+};
 
 module.exports = libsession_util_nodejs;
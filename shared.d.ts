@@ -23,6 +23,28 @@ declare module 'libsession_util_nodejs' {
   export type PushConfigResult = { data: Uint8Array; seqno: number; hashes: Array<string> };
   export type MergeSingle = { hash: string; data: Uint8Array };
 
+  /**
+   * Filter applied natively by the `query*` functions of the wrappers.
+   * Each key is a field of the record, and each value either a literal (strict equality) or an object of comparisons, all of which need to match.
+   * e.g. `{ approved: true, blocked: false, priority: { gt: 0 } }`
+   * Fields holding buffers or nested objects cannot be filtered on.
+   * Numbers must be integers, as all the numeric fields are: anything else throws.
+   */
+  export type QueryFilter<T> = {
+    [K in keyof T]?:
+      | T[K]
+      | null
+      | { eq?: T[K] | null; ne?: T[K] | null; gt?: T[K]; gte?: T[K]; lt?: T[K]; lte?: T[K] };
+  };
+
+  /**
+   * Query function returning only the records matching `filter` (all if null), marshalled with only the properties listed in `fields` (all if null).
+   */
+  export type QueryFunction<T> = <K extends keyof T>(
+    filter: QueryFilter<T> | null,
+    fields: Array<K> | null
+  ) => Array<Pick<T, K>>;
+
   type MakeActionCall<A extends RecordOfFunctions, B extends keyof A> = [B, ...Parameters<A[B]>];
 
   /**
@@ -31,6 +53,106 @@ declare module 'libsession_util_nodejs' {
    *
    */
 
+  export type MergeStats = {
+    /** number of messages skipped by the last merge */
+    lastSkipped: number;
+    /** number of messages skipped since this wrapper was created */
+    totalSkipped: number;
+    /** number of messages of the last merge (or batch of `ingest`) which could not be decrypted or parsed, and so were dropped */
+    lastUndecryptable: number;
+    /** number of hashes currently remembered */
+    seenHashes: number;
+  };
+
+  /**
+   * Indexes into the Int32Array returned by `statusBlock()`:
+   * - 0: flags, bit 0 set if the config needs a push, bit 1 if it needs a dump
+   * - 1: the seqno of the last push or confirmPushed (32 bits)
+   * - 2: a counter incremented on every change to the config (set/erase, merge, confirmPushed)
+   */
+  export type ConfigStatusIndex = 0 | 1 | 2;
+
+  export type ConfigChange = {
+    namespace: number;
+    /** 'local' for set/erase calls, 'merge' for incoming messages, 'confirmPushed' once a push is confirmed */
+    kinds: Array<'local' | 'merge' | 'confirmPushed'>;
+    needsPush: boolean;
+    needsDump: boolean;
+  };
+
+  export type AutoPersistOptions = {
+    /** the dump happens this long after the last change (default 1000ms)... */
+    debounceMs?: number;
+    /** ...but no later than this long after the first change not persisted yet (default 10000ms) */
+    maxLatencyMs?: number;
+  } & (
+    | {
+        /** the file the dump is written to (atomically replaced) */
+        path: string;
+        sink?: undefined;
+      }
+    | {
+        path?: undefined;
+        sink: (dump: Uint8Array) => void;
+      }
+  );
+
+  export type PersistStats = {
+    dumps: number;
+    /** bytes written to the file, or given to the sink */
+    bytesWritten: number;
+    /** changes which did not need a dump of their own, a later dump covering them */
+    coalescedMutations: number;
+    /** dumps which could not be written; the config then needs a dump again, and the write is retried */
+    writeErrors: number;
+  };
+
+  /** Opaque handle returned by `snapshot()` */
+  export type ConfigSnapshot = { readonly __configSnapshot: unique symbol };
+
+  /**
+   * Approximate native memory held by a wrapper, in bytes. The collections depend on the wrapper: `contacts`,
+   * `communities`, `legacyGroups` and `oneToOnes`.
+   */
+  export type ConfigMemoryUsage = {
+    collections: Record<string, { entries: number; bytes: number }>;
+    /** the last `push` result, kept until the config changes */
+    pushCache: number;
+    /** the hashes remembered by `merge` */
+    seenHashes: number;
+    /** the rollback points of the transactions in progress */
+    transactions: number;
+    /** the data of the last `snapshot` */
+    snapshot: number;
+    /** the messages given to `ingest` and not merged yet */
+    ingestBuffer: number;
+    total: number;
+  };
+
+  export type IngestOptions = {
+    /** a batch is merged once it has this many messages (default 256)... */
+    maxBatchMessages?: number;
+    /** ...or this many bytes (default 1MiB)... */
+    maxBatchBytes?: number;
+    /** ...or once its first message was written this long ago (default 50ms) */
+    maxDelayMs?: number;
+    /** `ingest` returns false while at least this many bytes are waiting to be merged (default 4MiB) */
+    highWaterBytes?: number;
+  };
+
+  export type IngestEvent = {
+    /** the hashes merged by this batch */
+    merged: Array<string>;
+    /** how many messages of this batch were not merged (they could not be decrypted or parsed) */
+    undecryptable: number;
+    /** false while `ingest` should not be called (it is still safe to, but memory use grows) */
+    writable: boolean;
+    /** set once `ingestEnd` was called and everything was merged */
+    done: boolean;
+    /** set if merging the batch failed */
+    error?: string;
+  };
+
   type BaseConfigWrapper = {
     needsDump: () => boolean;
     needsPush: () => boolean;
@@ -38,6 +160,93 @@ declare module 'libsession_util_nodejs' {
     dump: () => Uint8Array;
     confirmPushed: (seqno: number, hash: string) => void;
     merge: (toMerge: Array<MergeSingle>) => Array<string>; // merge returns the array of hashes that merged correctly
+    /**
+     * Same as `merge`, but with all the messages concatenated in `data`: message `i` has hash
+     * `hashes[i]` and is `data.subarray(offsets[i], offsets[i + 1])`, so `offsets` must have
+     * `hashes.length + 1` elements.
+     */
+    mergePacked: (hashes: Array<string>, data: Uint8Array, offsets: Uint32Array) => Array<string>;
+    /**
+     * Messages which were already merged (or pushed) are skipped by `merge` without being
+     * decrypted, but are still returned as merged. This reports how many were skipped.
+     */
+    mergeStats: () => MergeStats;
+    /** How many times `push` returned its cached result, the config being unchanged since the previous call. */
+    pushCacheHits: () => number;
+    /**
+     * Returns the status block of this wrapper, kept up to date natively so that it can be polled with `Atomics.load`
+     * instead of calling `needsPush`/`needsDump`. See `ConfigStatusIndex` for its layout.
+     * This is the same Int32Array on every call, unless its buffer was transferred or detached: a new one is then
+     * returned, and the old one is no longer updated.
+     * Note: this is a plain (not shared) buffer, so it can only be read from the thread owning the wrapper.
+     */
+    statusBlock: () => Int32Array;
+    /**
+     * Sets (or removes, with null) the function called after this wrapper changed. Changes made during the same JS task
+     * are reported by a single call, made once that task is done.
+     */
+    onChange: (listener: ((change: ConfigChange) => void) | null) => void;
+    /**
+     * Enables (or disables, with null) dumping this wrapper automatically once it changed, to a file or a callback.
+     * A write which fails is retried after `debounceMs`, then twice as long after each further failure (up to a minute).
+     * Pending dumps do not keep the process alive: call `flushPersist` before exiting.
+     */
+    autoPersist: (options: AutoPersistOptions | null) => void;
+    /** Dumps right away if needed (the file is written before returning). Returns true if a dump was made. */
+    flushPersist: () => boolean;
+    /** null when autoPersist is not enabled */
+    persistStats: () => PersistStats | null;
+    /**
+     * Captures the current state of this wrapper, to give to `restore` later. This takes a full dump of the config, so it
+     * costs O(size of the config), unless the wrapper is unchanged since the last snapshot: that one is then handed out
+     * again, sharing the same data.
+     */
+    snapshot: () => ConfigSnapshot;
+    /**
+     * Reverts this wrapper to the state captured by `snapshot` (which must come from this wrapper).
+     * Returns false, without doing anything, if the wrapper did not change since. Otherwise the config is rebuilt from the
+     * snapshot's dump, which costs as much as loading the wrapper from that dump.
+     * Only local changes can be reverted: throws if the wrapper merged messages or confirmed a push since the snapshot,
+     * as restoring it would lose those.
+     */
+    restore: (snapshot: ConfigSnapshot) => boolean;
+    /** The hashes `merge` will skip, to be persisted alongside the dump. */
+    seenHashes: () => Array<string>;
+    /** Restores the hashes returned by `seenHashes` after reloading from a dump. */
+    addSeenHashes: (hashes: Array<string>) => void;
+    /**
+     * Starts merging messages as they are given to `ingest`, in batches: each batch is merged on the next turn of the
+     * event loop once it is full (or old enough), then `listener` is called. Throws if the previous stream was not ended.
+     * See `createMergeStream` for a Writable doing all this.
+     */
+    ingestStart: (listener: (event: IngestEvent) => void, options?: IngestOptions | null) => void;
+    /** Returns false if the caller should wait for an event with `writable` set before ingesting more. */
+    ingest: (hash: string, data: Uint8Array) => boolean;
+    /** Merges what is left. Returns true if everything was already merged (no `done` event will follow). */
+    ingestEnd: () => boolean;
+    /**
+     * The size of what `push` would return, without compressing or encrypting anything. Exact if the last `push` result
+     * is still valid; otherwise approximate (normally an upper bound), computed from a dump of the config. Not free: the
+     * first call after a change serializes the whole config.
+     */
+    estimatePushSize: () => { bytes: number; exact: boolean };
+    /**
+     * How many more bytes fit in this config before a push exceeds `maxBytes` (default `CONSTANTS.CONFIG_MAX_PUSH_SIZE`),
+     * per `estimatePushSize`.
+     */
+    remainingCapacity: (maxBytes?: number | null) => number;
+    /** Approximate native memory held by this wrapper. */
+    memoryUsage: () => ConfigMemoryUsage;
+    /**
+     * Drops the caches (the last `push` result and `snapshot` data) and the spare capacity of the seen hashes, then gives
+     * the memory freed back to the OS. Returns how many bytes that freed, as measured by the allocator where possible
+     * (glibc; process-wide, so other threads' allocations meanwhile count too), else as estimated by `memoryUsage`.
+     * With `async`, giving the memory back happens off the JS thread.
+     */
+    compact: {
+      (options?: { async?: false } | null): number;
+      (options: { async: true }): Promise<number>;
+    };
     storageNamespace: () => number;
     currentHashes: () => Array<string>;
   };
@@ -49,6 +258,25 @@ declare module 'libsession_util_nodejs' {
     | MakeActionCall<BaseConfigWrapper, 'dump'>
     | MakeActionCall<BaseConfigWrapper, 'confirmPushed'>
     | MakeActionCall<BaseConfigWrapper, 'merge'>
+    | MakeActionCall<BaseConfigWrapper, 'mergePacked'>
+    | MakeActionCall<BaseConfigWrapper, 'mergeStats'>
+    | MakeActionCall<BaseConfigWrapper, 'pushCacheHits'>
+    | MakeActionCall<BaseConfigWrapper, 'statusBlock'>
+    | MakeActionCall<BaseConfigWrapper, 'onChange'>
+    | MakeActionCall<BaseConfigWrapper, 'snapshot'>
+    | MakeActionCall<BaseConfigWrapper, 'restore'>
+    | MakeActionCall<BaseConfigWrapper, 'autoPersist'>
+    | MakeActionCall<BaseConfigWrapper, 'flushPersist'>
+    | MakeActionCall<BaseConfigWrapper, 'persistStats'>
+    | MakeActionCall<BaseConfigWrapper, 'seenHashes'>
+    | MakeActionCall<BaseConfigWrapper, 'addSeenHashes'>
+    | MakeActionCall<BaseConfigWrapper, 'ingestStart'>
+    | MakeActionCall<BaseConfigWrapper, 'ingest'>
+    | MakeActionCall<BaseConfigWrapper, 'ingestEnd'>
+    | MakeActionCall<BaseConfigWrapper, 'estimatePushSize'>
+    | MakeActionCall<BaseConfigWrapper, 'remainingCapacity'>
+    | MakeActionCall<BaseConfigWrapper, 'memoryUsage'>
+    | MakeActionCall<BaseConfigWrapper, 'compact'>
     | MakeActionCall<BaseConfigWrapper, 'storageNamespace'>
     | MakeActionCall<BaseConfigWrapper, 'currentHashes'>;
 
@@ -59,12 +287,41 @@ declare module 'libsession_util_nodejs' {
     public dump: BaseConfigWrapper['dump'];
     public confirmPushed: BaseConfigWrapper['confirmPushed'];
     public merge: BaseConfigWrapper['merge'];
+    public mergePacked: BaseConfigWrapper['mergePacked'];
+    public mergeStats: BaseConfigWrapper['mergeStats'];
+    public pushCacheHits: BaseConfigWrapper['pushCacheHits'];
+    public statusBlock: BaseConfigWrapper['statusBlock'];
+    public onChange: BaseConfigWrapper['onChange'];
+    public snapshot: BaseConfigWrapper['snapshot'];
+    public restore: BaseConfigWrapper['restore'];
+    public autoPersist: BaseConfigWrapper['autoPersist'];
+    public flushPersist: BaseConfigWrapper['flushPersist'];
+    public persistStats: BaseConfigWrapper['persistStats'];
+    public seenHashes: BaseConfigWrapper['seenHashes'];
+    public addSeenHashes: BaseConfigWrapper['addSeenHashes'];
+    public ingestStart: BaseConfigWrapper['ingestStart'];
+    public ingest: BaseConfigWrapper['ingest'];
+    public ingestEnd: BaseConfigWrapper['ingestEnd'];
+    public estimatePushSize: BaseConfigWrapper['estimatePushSize'];
+    public remainingCapacity: BaseConfigWrapper['remainingCapacity'];
+    public memoryUsage: BaseConfigWrapper['memoryUsage'];
+    public compact: BaseConfigWrapper['compact'];
     public storageNamespace: BaseConfigWrapper['storageNamespace'];
     public currentHashes: BaseConfigWrapper['currentHashes'];
   }
 
   export type BaseWrapperActionsCalls = MakeWrapperActionCalls<BaseConfigWrapper>;
 
+  /**
+   * Returns an object mode Writable merging the `{ hash, data }` messages written to it into `wrapper`, with
+   * backpressure, so that memory stays bounded however many messages there are. It finishes once everything was merged,
+   * and emits a 'merged' event with the hashes merged by each batch.
+   */
+  export function createMergeStream(
+    wrapper: BaseConfigWrapperNode,
+    options?: IngestOptions
+  ): import('stream').Writable;
+
   export type ConstantsType = {
     /** 100 bytes */
     CONTACT_MAX_NAME_LENGTH: number;
@@ -77,6 +334,8 @@ declare module 'libsession_util_nodejs' {
      * BASE_URL_MAX_LENGTH + '/r/' + ROOM_MAX_LENGTH + qs_pubkey.size() + hex pubkey + null terminator
      */
     COMMUNITY_FULL_URL_MAX_LENGTH: number;
+    /** 76800 bytes - the largest config message the storage server accepts */
+    CONFIG_MAX_PUSH_SIZE: number;
   };
 
   export const CONSTANTS: ConstantsType;
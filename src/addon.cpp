@@ -1,11 +1,18 @@
 #include <napi.h>
 
 #include "blinding/blinding.hpp"
+#include "blinded_id_index.hpp"
+#include "blinding/blinding_context.hpp"
+#include "config_actor.hpp"
+#include "config_batch.hpp"
 #include "constants.hpp"
 #include "contacts_config.hpp"
+#include "conversation_list.hpp"
 #include "convo_info_volatile_config.hpp"
+#include "meta_group_wrapper.hpp"
 #include "user_config.hpp"
 #include "user_groups_config.hpp"
+#include "verification/verification.hpp"
 
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
     using namespace session::nodeapi;
@@ -15,9 +22,19 @@ Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
     ContactsConfigWrapper::Init(env, exports);
     UserGroupsWrapper::Init(env, exports);
     ConvoInfoVolatileWrapper::Init(env, exports);
+    ContactsReadOnlyWrapper::Init(env, exports);
+    ConvoInfoVolatileReadOnlyWrapper::Init(env, exports);
+    UserGroupsReadOnlyWrapper::Init(env, exports);
+    BlindingContextWrapper::Init(env, exports);
+    BlindedIdIndexWrapper::Init(env, exports);
+    ConfigActorWrapper::Init(env, exports);
+    MetaGroupWrapper::Init(env, exports);
 
     // Fully static wrappers init
     BlindingWrapper::Init(env, exports);
+    ConfigBatchWrapper::Init(env, exports);
+    ConversationListWrapper::Init(env, exports);
+    VerificationWrapper::Init(env, exports);
 
     return exports;
 }
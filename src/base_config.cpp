@@ -1,5 +1,11 @@
 #include "base_config.hpp"
 
+#include <utility>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 #include "session/config/base.hpp"
 #include "session/config/encrypt.hpp"
 
@@ -7,8 +13,52 @@ namespace session::nodeapi {
 
 using config::ConfigBase;
 
+namespace {
+
+    // Gives the memory the allocator keeps around for further allocations back to the OS, where
+    // the allocator supports it.
+    void trim_heap() {
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+    }
+
+    // The bytes the allocator handed out and didn't get back yet (process-wide), where it can
+    // tell.
+    std::optional<size_t> heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        auto info = mallinfo2();
+        return info.uordblks + info.hblkhd;
+#else
+        return std::nullopt;
+#endif
+    }
+
+    // Trims the heap on the thread pool, which can take a while with a large heap, and then
+    // resolves with `freed`.
+    class TrimWorker : public Napi::AsyncWorker {
+      public:
+        TrimWorker(Napi::Env env, size_t freed) :
+                Napi::AsyncWorker{env},
+                deferred_{Napi::Promise::Deferred::New(env)},
+                freed_{freed} {}
+
+        Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+      protected:
+        void Execute() override { trim_heap(); }
+        void OnOK() override { deferred_.Resolve(toJs(Env(), freed_)); }
+        void OnError(const Napi::Error& e) override { deferred_.Reject(e.Value()); }
+
+      private:
+        Napi::Promise::Deferred deferred_;
+        size_t freed_;
+    };
+
+}  // namespace
+
 Napi::Value ConfigBaseImpl::needsDump(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return get_config<ConfigBase>().needs_dump(); });
+    return wrapResult(info, [&] { return needsDumpConfig(); });
 }
 
 Napi::Value ConfigBaseImpl::needsPush(const Napi::CallbackInfo& info) {
@@ -16,9 +66,7 @@ Napi::Value ConfigBaseImpl::needsPush(const Napi::CallbackInfo& info) {
 }
 
 Napi::Value ConfigBaseImpl::storageNamespace(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] {
-        return static_cast<uint16_t>(get_config<ConfigBase>().storage_namespace());
-    });
+    return wrapResult(info, [&] { return storageNamespaceConfig(); });
 }
 
 Napi::Value ConfigBaseImpl::currentHashes(const Napi::CallbackInfo& info) {
@@ -28,7 +76,8 @@ Napi::Value ConfigBaseImpl::currentHashes(const Napi::CallbackInfo& info) {
 Napi::Value ConfigBaseImpl::push(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&]() {
         assertInfoLength(info, 0);
-        auto [seqno, to_push, hashes] = get_config<ConfigBase>().push();
+        auto [seqno, to_push, hashes] = pushConfig();
+        updateStatus();
 
         auto env = info.Env();
         Napi::Object result = Napi::Object::New(env);
@@ -43,7 +92,7 @@ Napi::Value ConfigBaseImpl::push(const Napi::CallbackInfo& info) {
 Napi::Value ConfigBaseImpl::dump(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&]() {
         assertInfoLength(info, 0);
-        return get_config<ConfigBase>().dump();
+        return dumpConfig();
     });
 }
 
@@ -53,12 +102,397 @@ void ConfigBaseImpl::confirmPushed(const Napi::CallbackInfo& info) {
         assertIsNumber(info[0]);
         assertIsString(info[1]);
 
-        get_config<ConfigBase>().confirm_pushed(
+        confirmPushedConfig(
                 toCppInteger(info[0], "confirmPushed", false),
                 toCppString(info[1], "confirmPushed"));
     });
 }
 
+uint16_t ConfigBaseImpl::storageNamespaceConfig() {
+    return static_cast<uint16_t>(get_config<ConfigBase>().storage_namespace());
+}
+
+bool ConfigBaseImpl::needsPushConfig() {
+    return get_config<ConfigBase>().needs_push();
+}
+
+bool ConfigBaseImpl::needsDumpConfig() {
+    return dump_pending_ || get_config<ConfigBase>().needs_dump();
+}
+
+ustring ConfigBaseImpl::dumpConfig() {
+    auto dumped = get_config<ConfigBase>().dump();
+    dump_pending_ = false;
+    updateStatus();
+    return dumped;
+}
+
+std::tuple<config::seqno_t, ustring, std::vector<std::string>> ConfigBaseImpl::pushConfig() {
+    if (auto* cached = push_cache_.get())
+        return *cached;
+    auto& pushed = push_cache_.set(get_config<ConfigBase>().push());
+    last_seqno_ = std::get<0>(pushed);
+    return pushed;
+}
+
+void ConfigBaseImpl::confirmPushedConfig(config::seqno_t seqno, const std::string& hash) {
+    get_config<ConfigBase>().confirm_pushed(seqno, hash);
+    last_seqno_ = seqno;
+    mutated(ChangeKind::confirmPushed);
+    seen_hashes_.seed(get_config<ConfigBase>());
+    seen_hashes_.add(hash);
+}
+
+size_t ConfigBaseImpl::estimatePushSizeConfig(bool* exact) {
+    if (exact)
+        *exact = push_cache_.has();
+    if (auto size = push_cache_.size())
+        return *size;
+
+    // A dump holds the serialized message push() compresses, pads and encrypts (plus a little
+    // state): padding it the way push() does, with libsession's own padding, and adding what the
+    // encryption adds gives an upper bound of the push size.  This still serializes the whole
+    // config (only the compression and encryption are saved), so the estimate is cached until the
+    // next change.
+    auto data = internalDump();
+    config::pad_message(data);
+    size_t estimate = data.size() + config::ENCRYPT_DATA_OVERHEAD;
+    push_cache_.setEstimate(estimate);
+    return estimate;
+}
+
+Napi::Value ConfigBaseImpl::estimatePushSize(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        bool exact;
+        auto bytes = estimatePushSizeConfig(&exact);
+        auto env = info.Env();
+        auto obj = Napi::Object::New(env);
+        obj["bytes"] = toJs(env, bytes);
+        obj["exact"] = toJs(env, exact);
+        return obj;
+    });
+}
+
+Napi::Value ConfigBaseImpl::remainingCapacity(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        if (info.Length() > 1)
+            throw std::invalid_argument{"Invalid number of arguments"};
+        size_t max_bytes = MAX_PUSH_SIZE;
+        if (info.Length() == 1 && !info[0].IsNull() && !info[0].IsUndefined()) {
+            assertIsNumber(info[0]);
+            auto max = toCppInteger(info[0], "remainingCapacity.maxBytes");
+            if (max < 0)
+                throw std::invalid_argument{"remainingCapacity: maxBytes must be >= 0"};
+            max_bytes = static_cast<size_t>(max);
+        }
+        auto bytes = estimatePushSizeConfig();
+        return bytes < max_bytes ? max_bytes - bytes : size_t{0};
+    });
+}
+
+size_t ConfigBaseImpl::MemoryUsage::total() const {
+    size_t total = push_cache + seen_hashes + transactions + snapshot + ingest_buffer;
+    for (const auto& c : collections)
+        total += c.bytes;
+    return total;
+}
+
+ConfigBaseImpl::MemoryUsage ConfigBaseImpl::memoryUsageConfig() {
+    MemoryUsage usage;
+    usage.collections = collectionUsage();
+    usage.push_cache = push_cache_.memoryUsage();
+    usage.seen_hashes = seen_hashes_.memoryUsage();
+    usage.transactions = history_.transactionBytes();
+    // (the snapshot's dump is shared with the snapshots handed out, but it is still held here)
+    usage.snapshot = history_.snapshotBytes();
+    if (ingestor_)
+        usage.ingest_buffer = ingestor_->pendingBytes();
+    return usage;
+}
+
+Napi::Object toJs_impl<ConfigBaseImpl::MemoryUsage>::operator()(
+        const Napi::Env& env, const ConfigBaseImpl::MemoryUsage& usage) {
+    auto collections = Napi::Object::New(env);
+    for (const auto& c : usage.collections) {
+        auto obj = Napi::Object::New(env);
+        obj["entries"] = toJs(env, c.entries);
+        obj["bytes"] = toJs(env, c.bytes);
+        collections[c.name] = obj;
+    }
+
+    auto obj = Napi::Object::New(env);
+    obj["collections"] = collections;
+    obj["pushCache"] = toJs(env, usage.push_cache);
+    obj["seenHashes"] = toJs(env, usage.seen_hashes);
+    obj["transactions"] = toJs(env, usage.transactions);
+    obj["snapshot"] = toJs(env, usage.snapshot);
+    obj["ingestBuffer"] = toJs(env, usage.ingest_buffer);
+    obj["total"] = toJs(env, usage.total());
+    return obj;
+}
+
+size_t ConfigBaseImpl::compactConfig() {
+    auto estimate_before = memoryUsageConfig().total();
+
+    // (libsession keeps its entries in node-based containers, which give their memory back as
+    // entries are erased: only what the wrapper keeps on top of the config can be dropped)
+    auto before = heap_in_use();
+    push_cache_.invalidate();
+    history_.dropLastSnapshot();
+    seen_hashes_.shrink();
+    auto after = heap_in_use();
+
+    reportExternalMemory(true);
+    if (before && after)
+        return *before > *after ? *before - *after : 0;
+    auto estimate_after = memoryUsageConfig().total();
+    return estimate_before > estimate_after ? estimate_before - estimate_after : 0;
+}
+
+Napi::Value ConfigBaseImpl::compact(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&]() -> Napi::Value {
+        bool async = false;
+        if (info.Length() > 0 && !info[0].IsNull() && !info[0].IsUndefined()) {
+            assertIsObject(info[0]);
+            auto async_opt = info[0].As<Napi::Object>().Get("async");
+            async = !async_opt.IsUndefined() && toCppBoolean(async_opt, "compact.async");
+        }
+
+        // The config can't be rebuilt off the JS thread (nothing else may touch it meanwhile), but
+        // giving the memory back to the OS can be.
+        auto freed = compactConfig();
+        if (!async) {
+            trim_heap();
+            return toJs(env, freed);
+        }
+        auto* worker = new TrimWorker{env, freed};
+        auto promise = worker->GetPromise();
+        worker->Queue();
+        return promise;
+    });
+}
+
+Napi::Value ConfigBaseImpl::memoryUsage(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return toJs(info.Env(), memoryUsageConfig());
+    });
+}
+
+Napi::Value ConfigBaseImpl::pushCacheHits(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return push_cache_.hits();
+    });
+}
+
+Napi::Value ConfigBaseImpl::statusBlock(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return status_.get(info.Env(), currentStatus());
+    });
+}
+
+StatusBlock::Status ConfigBaseImpl::currentStatus() {
+    return {needsPushConfig(), needsDumpConfig(), last_seqno_, mutation_count_};
+}
+
+void ConfigBaseImpl::updateStatus() {
+    if (status_.active())
+        status_.update(currentStatus());
+}
+
+ConfigBaseImpl::~ConfigBaseImpl() {
+    live_wrappers_.erase(this);
+}
+
+void ConfigBaseImpl::onChange(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        change_notifier_.reset();
+        if (info[0].IsNull() || info[0].IsUndefined())
+            return;
+        if (!info[0].IsFunction())
+            throw std::invalid_argument{"onChange: expected a function or null"};
+
+        change_notifier_ = std::make_unique<ChangeNotifier>(
+                info.Env(), info[0].As<Napi::Function>(), storageNamespaceConfig());
+    });
+}
+
+void ConfigBaseImpl::autoPersist(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        persist_.reset();
+        if (info[0].IsNull() || info[0].IsUndefined())
+            return;
+        assertIsObject(info[0]);
+        auto obj = info[0].As<Napi::Object>();
+        auto env = info.Env();
+
+        auto options = PersistScheduler::optionsFromJs(env, obj);
+
+        persist_ = std::make_unique<PersistScheduler>(
+                env,
+                std::move(options),
+                [this]() -> std::optional<ustring> {
+                    if (!needsDumpConfig())
+                        return std::nullopt;
+                    return dumpConfig();
+                },
+                [this] {
+                    dump_pending_ = true;
+                    updateStatus();
+                });
+        if (needsDumpConfig())
+            persist_->notify();
+    });
+}
+
+Napi::Value ConfigBaseImpl::flushPersist(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        if (!persist_)
+            throw std::logic_error{"flushPersist: autoPersist is not enabled"};
+        return persist_->flush();
+    });
+}
+
+Napi::Value ConfigBaseImpl::persistStats(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&]() -> Napi::Value {
+        assertInfoLength(info, 0);
+        if (!persist_)
+            return env.Null();
+        const auto& metrics = persist_->metrics();
+        auto obj = Napi::Object::New(env);
+        obj["dumps"] = toJs(env, metrics.dumps);
+        obj["bytesWritten"] = toJs(env, metrics.bytes_written);
+        obj["coalescedMutations"] = toJs(env, metrics.coalesced_mutations);
+        obj["writeErrors"] = toJs(env, metrics.write_errors);
+        return obj;
+    });
+}
+
+void ConfigBaseImpl::mutated(ChangeKind kind) {
+    push_cache_.invalidate();
+    mutation_count_++;
+    if (kind != ChangeKind::local)
+        remote_changes_++;
+    updateStatus();
+
+    // A merge can change any amount of data, unlike local changes
+    reportExternalMemory(kind == ChangeKind::merge);
+
+    if (history_.inTransaction())
+        history_.defer(static_cast<uint8_t>(kind));
+    else
+        notifyChange(static_cast<uint8_t>(kind));
+}
+
+void ConfigBaseImpl::reportExternalMemory(bool force) {
+    if (external_memory_.due(mutation_count_, force))
+        external_memory_.report(memoryUsageConfig().total());
+}
+
+void ConfigBaseImpl::notifyChange(uint8_t kinds) {
+    if (persist_)
+        persist_->notify();
+    if (change_notifier_)
+        change_notifier_->notify(kinds, needsPushConfig(), needsDumpConfig());
+    changeNotified();
+}
+
+ustring ConfigBaseImpl::internalDump() {
+    auto& conf = get_config<ConfigBase>();
+    if (conf.needs_dump())
+        dump_pending_ = true;
+    return conf.dump();
+}
+
+void ConfigBaseImpl::replaceConfig(ustring_view dump) {
+    auto fresh = rebuild_(dump);
+    fresh->logger = std::move(conf_->logger);
+    conf_ = std::move(fresh);
+}
+
+ConfigHistory::Point ConfigBaseImpl::historyPoint(std::shared_ptr<const ustring> dump) {
+    return {instance_id_, mutation_count_, remote_changes_, last_seqno_, std::move(dump)};
+}
+
+void ConfigBaseImpl::reloadFrom(const ConfigHistory::Point& point) {
+    replaceConfig(*point.dump);
+    last_seqno_ = point.last_seqno;
+    remote_changes_ = point.remote_changes;
+
+    // Everything derived from the previous config data is now stale
+    push_cache_.invalidate();
+    mutation_count_++;
+    updateStatus();
+    reportExternalMemory(true);
+    onExternalChange();
+}
+
+Napi::Value ConfigBaseImpl::snapshot(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&] {
+        assertInfoLength(info, 0);
+        if (!rebuild_)
+            throw std::logic_error{"This config does not support snapshots"};
+        return history_.snapshot(env, historyPoint(), [this] { return internalDump(); });
+    });
+}
+
+Napi::Value ConfigBaseImpl::restore(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        auto snap = ConfigHistory::unwrapSnapshot(info.Env(), info[0], instance_id_);
+        if (snap.mutation_count == mutation_count_)
+            return false;
+        if (snap.remote_changes != remote_changes_)
+            throw std::logic_error{
+                    "restore: the wrapper merged messages or confirmed a push since the snapshot"};
+
+        // (the seen hashes stay valid: nothing merged since the snapshot is lost)
+        reloadFrom(snap);
+        mutated(ChangeKind::local);
+        // The config is now back to the snapshot's state, so it can be handed out again as is
+        snap.mutation_count = mutation_count_;
+        history_.setLastSnapshot(std::move(snap));
+        return true;
+    });
+}
+
+void ConfigBaseImpl::beginTransaction() {
+    if (!rebuild_)
+        throw std::logic_error{"This config does not support transactions"};
+    history_.begin(historyPoint(std::make_shared<const ustring>(internalDump())));
+}
+
+void ConfigBaseImpl::commitTransaction() {
+    history_.end("commitTransaction");
+    if (!history_.inTransaction())
+        if (auto deferred = history_.takeDeferred())
+            notifyChange(deferred);
+}
+
+void ConfigBaseImpl::rollbackTransaction() {
+    auto tx = history_.end("rollbackTransaction");
+
+    // Nothing to revert when the config was not touched: that is what makes a rollback cheap
+    if (tx.mutation_count != mutation_count_) {
+        bool merged = tx.remote_changes != remote_changes_;
+        reloadFrom(tx);
+        // The messages merged during the transaction must not be skipped when merged again
+        if (merged)
+            seen_hashes_.clear();
+    }
+    if (!history_.inTransaction())
+        history_.takeDeferred();
+}
+
 Napi::Value ConfigBaseImpl::merge(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&]() {
         assertInfoLength(info, 1);
@@ -80,8 +514,162 @@ Napi::Value ConfigBaseImpl::merge(const Napi::CallbackInfo& info) {
                     toCppBufferView(itemObject.Get("data"), "base.merge"));
         }
 
-        return get_config<ConfigBase>().merge(conf_strs);
+        return mergeMessages(conf_strs);
+    });
+}
+
+Napi::Value ConfigBaseImpl::mergePacked(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&]() {
+        assertInfoLength(info, 3);
+        assertIsArray(info[0]);
+        assertIsUInt8Array(info[1]);
+        if (!info[2].IsTypedArray() ||
+            info[2].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array)
+            throw std::invalid_argument{"mergePacked: offsets must be a Uint32Array"};
+
+        Napi::Array hashes = info[0].As<Napi::Array>();
+        ustring_view data = toCppBufferView(info[1], "base.mergePacked");
+        auto offsets = info[2].As<Napi::Uint32Array>();
+
+        // offsets holds the boundaries of the messages within `data`, i.e. message i is
+        // data[offsets[i], offsets[i+1])
+        if (offsets.ElementLength() != hashes.Length() + 1)
+            throw std::invalid_argument{
+                    "mergePacked: offsets must have one more element than hashes"};
+
+        std::vector<std::pair<std::string, ustring_view>> conf_strs;
+        conf_strs.reserve(hashes.Length());
+
+        for (uint32_t i = 0; i < hashes.Length(); i++) {
+            uint32_t start = offsets[i], end = offsets[i + 1];
+            if (start > end || end > data.size())
+                throw std::invalid_argument{"mergePacked: invalid offsets"};
+
+            conf_strs.emplace_back(
+                    toCppString(hashes.Get(i), "base.mergePacked"),
+                    data.substr(start, end - start));
+        }
+
+        return mergeMessages(conf_strs);
+    });
+}
+
+Napi::Value ConfigBaseImpl::mergeStats(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        auto env = info.Env();
+        auto obj = Napi::Object::New(env);
+        obj["lastSkipped"] = toJs(env, merge_stats_.last_skipped);
+        obj["totalSkipped"] = toJs(env, merge_stats_.total_skipped);
+        obj["lastUndecryptable"] = toJs(env, merge_stats_.last_undecryptable);
+        obj["seenHashes"] = toJs(env, seen_hashes_.size());
+        return obj;
+    });
+}
+
+Napi::Value ConfigBaseImpl::seenHashes(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        seen_hashes_.seed(get_config<ConfigBase>());
+        return seen_hashes_.list();
+    });
+}
+
+void ConfigBaseImpl::addSeenHashes(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        assertIsArray(info[0]);
+        auto hashes = info[0].As<Napi::Array>();
+        seen_hashes_.seed(get_config<ConfigBase>());
+        for (uint32_t i = 0; i < hashes.Length(); i++)
+            seen_hashes_.add(toCppString(hashes.Get(i), "base.addSeenHashes"));
+    });
+}
+
+void ConfigBaseImpl::ingestStart(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        if (info.Length() < 1 || info.Length() > 2)
+            throw std::invalid_argument{"Invalid number of arguments"};
+        if (!info[0].IsFunction())
+            throw std::invalid_argument{"ingestStart: expected a listener function"};
+        if (ingestor_ && !ingestor_->done())
+            throw std::logic_error{"ingestStart: the previous stream was not ended"};
+
+        MergeIngestor::Options options;
+        if (info.Length() > 1 && !info[1].IsNull() && !info[1].IsUndefined()) {
+            assertIsObject(info[1]);
+            auto obj = info[1].As<Napi::Object>();
+            if (auto v = obj.Get("maxBatchMessages"); !v.IsUndefined())
+                options.max_batch_messages =
+                        toCppInteger(v, "ingestStart.maxBatchMessages", false);
+            if (auto v = obj.Get("maxBatchBytes"); !v.IsUndefined())
+                options.max_batch_bytes = toCppInteger(v, "ingestStart.maxBatchBytes", false);
+            if (auto v = obj.Get("maxDelayMs"); !v.IsUndefined())
+                options.max_delay_ms = toCppInteger(v, "ingestStart.maxDelayMs", false);
+            if (auto v = obj.Get("highWaterBytes"); !v.IsUndefined())
+                options.high_water_bytes = toCppInteger(v, "ingestStart.highWaterBytes", false);
+        }
+
+        ingestor_ = std::make_unique<MergeIngestor>(
+                info.Env(),
+                options,
+                [this](const auto& msgs) { return mergeMessages(msgs); },
+                info[0].As<Napi::Function>());
     });
 }
 
+Napi::Value ConfigBaseImpl::ingest(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 2);
+        assertIsString(info[0]);
+        assertIsUInt8Array(info[1]);
+        if (!ingestor_)
+            throw std::logic_error{"ingest: ingestStart was not called"};
+        return ingestor_->write(
+                toCppString(info[0], "base.ingest"), toCppBuffer(info[1], "base.ingest"));
+    });
+}
+
+Napi::Value ConfigBaseImpl::ingestEnd(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        if (!ingestor_)
+            throw std::logic_error{"ingestEnd: ingestStart was not called"};
+        return ingestor_->end();
+    });
+}
+
+std::vector<std::string> ConfigBaseImpl::mergeMessages(
+        const std::vector<std::pair<std::string, ustring_view>>& conf_strs) {
+    seen_hashes_.seed(get_config<ConfigBase>());
+
+    // Messages we already merged are reported as merged again, without going through libsession
+    std::vector<std::string> skipped;
+    std::vector<std::pair<std::string, ustring_view>> to_merge;
+    to_merge.reserve(conf_strs.size());
+    for (const auto& [hash, data] : conf_strs) {
+        if (seen_hashes_.contains(hash))
+            skipped.push_back(hash);
+        else
+            to_merge.emplace_back(hash, data);
+    }
+    merge_stats_.last_skipped = skipped.size();
+    merge_stats_.total_skipped += skipped.size();
+
+    merge_stats_.last_undecryptable = 0;
+
+    if (to_merge.empty())
+        return skipped;
+
+    auto merged = get_config<ConfigBase>().merge(to_merge);
+    merge_stats_.last_undecryptable = to_merge.size() - merged.size();
+    for (const auto& hash : merged)
+        seen_hashes_.add(hash);
+    mutated(ChangeKind::merge);
+    onExternalChange();
+
+    merged.insert(merged.end(), skipped.begin(), skipped.end());
+    return merged;
+}
+
 }  // namespace session::nodeapi
@@ -1,14 +1,29 @@
 #pragma once
 
 #include <napi.h>
+#include <sodium/utils.h>
 
+#include <atomic>
 #include <cassert>
+#include <functional>
 #include <memory>
+#include <new>
+#include <optional>
 #include <stdexcept>
+#include <tuple>
 #include <unordered_set>
 
+#include "change_notifier.hpp"
+#include "config_history.hpp"
+#include "external_memory.hpp"
+#include "log_queue.hpp"
+#include "merge_ingestor.hpp"
+#include "persist_scheduler.hpp"
+#include "push_cache.hpp"
+#include "seen_hashes.hpp"
 #include "session/config/base.hpp"
 #include "session/types.hpp"
+#include "status_block.hpp"
 #include "utilities.hpp"
 
 namespace session::nodeapi {
@@ -17,15 +32,110 @@ class ConfigBaseImpl;
 template <typename T>
 inline constexpr bool is_derived_napi_wrapper = std::is_base_of_v<Napi::ObjectWrap<T>, T>;
 
+// Returns a napi type tag unique to the wrapper type `T` (within this process), used to make sure
+// a JS object really wraps a `T` before unwrapping it.
+template <typename T>
+const napi_type_tag* wrapper_type_tag() {
+    static const napi_type_tag tag{0x6c69627365737369ULL, reinterpret_cast<uintptr_t>(&tag)};
+    return &tag;
+}
+
 /// Base implementation class for config types; this provides the napi wrappers for the base
 /// methods.  Subclasses should inherit from this (alongside Napi::ObjectWrap<ConfigBaseWrapper>)
 /// and wrap their method list argument in `DefineClass` with a call to
 /// `ConfigBaseImpl::WithBaseMethods<Subtype>({...})` to have the base methods added to the derived
 /// type appropriately.
+///
+/// What the wrapper keeps on top of the config is handled by separate components (PushCache,
+/// SeenHashes, StatusBlock, ConfigHistory, ChangeNotifier, PersistScheduler, MergeIngestor and
+/// ExternalMemory); this class ties them to the config and exposes them to JS.
 class ConfigBaseImpl {
 
     std::shared_ptr<config::ConfigBase> conf_;
 
+    // Unique to each wrapper instance (unlike its address, which can be reused)
+    const uint64_t instance_id_ = next_instance_id_++;
+    static inline std::atomic<uint64_t> next_instance_id_{1};
+
+    // Builds a new config of the same type from the given dump (see `construct`); empty when the
+    // subclass built its config some other way.
+    std::function<std::shared_ptr<config::ConfigBase>(ustring_view dump)> rebuild_;
+
+    // Set when a dump made for internal purposes (such as a transaction's rollback point) cleared
+    // the config's `needs_dump()` flag: a dump is still needed as far as the app is concerned.
+    bool dump_pending_ = false;
+
+    // The rollback points of the transactions in progress, and the last snapshot.  Changes made
+    // during a transaction only notify the `onChange` listener and persist scheduler when it
+    // commits.
+    ConfigHistory history_;
+
+    // The hashes of the messages already merged (or pushed) by this config
+    SeenHashes seen_hashes_;
+    // Reported by `mergeStats()`
+    struct MergeStats {
+        size_t last_skipped = 0;
+        size_t total_skipped = 0;
+        size_t last_undecryptable = 0;
+    } merge_stats_;
+
+    // The last push() result and push size estimate, until the config changes
+    PushCache push_cache_;
+
+    // Incremented by every call to `mutated()`.
+    uint32_t mutation_count_ = 0;
+    // The seqno of the last push() or confirmPushed() (libsession has no cheaper way to get it).
+    config::seqno_t last_seqno_ = 0;
+    // Incremented by every merge and confirmPushed: a snapshot taken before one of those can't be
+    // restored, as that would lose the changes of other devices, or the record of our own pushes.
+    uint32_t remote_changes_ = 0;
+
+    // Returned by `statusBlock()`
+    StatusBlock status_;
+    StatusBlock::Status currentStatus();
+
+    // Notifies the `onChange` listener and persist scheduler of the given ChangeKinds.
+    void notifyChange(uint8_t kinds);
+
+    // Dumps the config for internal use, without losing track of whether the app needs a dump.
+    ustring internalDump();
+    // Replaces the config by one built from `dump`.  The current config is left as it was if that
+    // fails.
+    void replaceConfig(ustring_view dump);
+    // The config's current state, as a snapshot or rollback point holding `dump`.
+    ConfigHistory::Point historyPoint(std::shared_ptr<const ustring> dump = nullptr);
+    // Reverts the config to `point` (a snapshot or rollback point).
+    void reloadFrom(const ConfigHistory::Point& point);
+
+    // Where the config's logger sends its lines (shared with it); null when the subclass built its
+    // config some other way.
+    std::shared_ptr<LogQueue> logs_;
+
+    // Set by `onChange`
+    std::unique_ptr<ChangeNotifier> change_notifier_;
+
+    // Set by `autoPersist`
+    std::unique_ptr<PersistScheduler> persist_;
+
+    // Set by `ingestStart`, and kept (once done) until the next stream is started
+    std::unique_ptr<MergeIngestor> ingestor_;
+
+    // The native size of this wrapper as reported to V8 (see `reportExternalMemory`)
+    ExternalMemory external_memory_;
+
+    // Tells V8 how much native memory this wrapper holds, so that garbage collection accounts for
+    // it.  Does nothing unless `force` is set or enough changes were made since the last report.
+    void reportExternalMemory(bool force);
+
+    // The wrappers alive on this thread (i.e. in this JS environment), for `memoryUsageAll`
+    static inline thread_local std::unordered_set<ConfigBaseImpl*> live_wrappers_;
+
+    // Common implementation of `merge` and `mergePacked` once the messages have been extracted from
+    // the JS arguments.  Messages already seen are skipped (but still reported as merged).  Returns
+    // the hashes of the messages that were merged successfully.
+    std::vector<std::string> mergeMessages(
+            const std::vector<std::pair<std::string, ustring_view>>& conf_strs);
+
   public:
     // These are exposed as read-only accessors rather than methods:
     Napi::Value needsDump(const Napi::CallbackInfo& info);
@@ -37,6 +147,25 @@ class ConfigBaseImpl {
     Napi::Value dump(const Napi::CallbackInfo& info);
     void confirmPushed(const Napi::CallbackInfo& info);
     Napi::Value merge(const Napi::CallbackInfo& info);
+    Napi::Value mergePacked(const Napi::CallbackInfo& info);
+    Napi::Value mergeStats(const Napi::CallbackInfo& info);
+    Napi::Value pushCacheHits(const Napi::CallbackInfo& info);
+    Napi::Value statusBlock(const Napi::CallbackInfo& info);
+    void onChange(const Napi::CallbackInfo& info);
+    Napi::Value snapshot(const Napi::CallbackInfo& info);
+    Napi::Value restore(const Napi::CallbackInfo& info);
+    void autoPersist(const Napi::CallbackInfo& info);
+    Napi::Value flushPersist(const Napi::CallbackInfo& info);
+    Napi::Value persistStats(const Napi::CallbackInfo& info);
+    Napi::Value seenHashes(const Napi::CallbackInfo& info);
+    void addSeenHashes(const Napi::CallbackInfo& info);
+    void ingestStart(const Napi::CallbackInfo& info);
+    Napi::Value ingest(const Napi::CallbackInfo& info);
+    Napi::Value ingestEnd(const Napi::CallbackInfo& info);
+    Napi::Value estimatePushSize(const Napi::CallbackInfo& info);
+    Napi::Value remainingCapacity(const Napi::CallbackInfo& info);
+    Napi::Value memoryUsage(const Napi::CallbackInfo& info);
+    Napi::Value compact(const Napi::CallbackInfo& info);
 
     // Called from a sub-type's Init function (typically indirectly, via InitHelper) to add the base
     // class properties/methods to the type.
@@ -57,30 +186,183 @@ class ConfigBaseImpl {
         properties.push_back(T::InstanceMethod("dump", &T::dump));
         properties.push_back(T::InstanceMethod("confirmPushed", &T::confirmPushed));
         properties.push_back(T::InstanceMethod("merge", &T::merge));
+        properties.push_back(T::InstanceMethod("mergePacked", &T::mergePacked));
+        properties.push_back(T::InstanceMethod("mergeStats", &T::mergeStats));
+        properties.push_back(T::InstanceMethod("pushCacheHits", &T::pushCacheHits));
+        properties.push_back(T::InstanceMethod("statusBlock", &T::statusBlock));
+        properties.push_back(T::InstanceMethod("onChange", &T::onChange));
+        properties.push_back(T::InstanceMethod("snapshot", &T::snapshot));
+        properties.push_back(T::InstanceMethod("restore", &T::restore));
+        properties.push_back(T::InstanceMethod("autoPersist", &T::autoPersist));
+        properties.push_back(T::InstanceMethod("flushPersist", &T::flushPersist));
+        properties.push_back(T::InstanceMethod("persistStats", &T::persistStats));
+        properties.push_back(T::InstanceMethod("seenHashes", &T::seenHashes));
+        properties.push_back(T::InstanceMethod("addSeenHashes", &T::addSeenHashes));
+        properties.push_back(T::InstanceMethod("ingestStart", &T::ingestStart));
+        properties.push_back(T::InstanceMethod("ingest", &T::ingest));
+        properties.push_back(T::InstanceMethod("ingestEnd", &T::ingestEnd));
+        properties.push_back(T::InstanceMethod("estimatePushSize", &T::estimatePushSize));
+        properties.push_back(T::InstanceMethod("remainingCapacity", &T::remainingCapacity));
+        properties.push_back(T::InstanceMethod("memoryUsage", &T::memoryUsage));
+        properties.push_back(T::InstanceMethod("compact", &T::compact));
 
         return properties;
     }
 
+    // Unwraps a JS object which must have been constructed as a `T` (see `tagInstance`) and
+    // returns its config as a `Config`.  Throws std::invalid_argument if the object is anything
+    // else.  This is what lets static functions operate on several wrappers passed from JS.
+    template <
+            typename T,
+            typename Config,
+            std::enable_if_t<is_derived_napi_wrapper<T>, int> = 0,
+            std::enable_if_t<std::is_base_of_v<config::ConfigBase, Config>, int> = 0>
+    static Config& unwrapConfig(Napi::Value val, const std::string& identifier) {
+        return unwrapImpl<T>(val, identifier).template get_config<Config>();
+    }
+
+    // Same as above, but returns the wrapper itself (as a ConfigBaseImpl), or nullptr if `val` is
+    // not a `T`.
+    template <typename T, std::enable_if_t<is_derived_napi_wrapper<T>, int> = 0>
+    static ConfigBaseImpl* maybeUnwrapImpl(Napi::Value val) {
+        if (!val.IsObject() || !val.As<Napi::Object>().CheckTypeTag(wrapper_type_tag<T>()))
+            return nullptr;
+        return T::Unwrap(val.As<Napi::Object>());
+    }
+
+    template <typename T, std::enable_if_t<is_derived_napi_wrapper<T>, int> = 0>
+    static ConfigBaseImpl& unwrapImpl(Napi::Value val, const std::string& identifier) {
+        if (auto* impl = maybeUnwrapImpl<T>(val))
+            return *impl;
+        throw std::invalid_argument{identifier + ": wrong wrapper type given"};
+    }
+
+    // The largest message the storage server accepts for a config, i.e. the limit on the size of
+    // what push() returns.  This is the server's current limit: `remainingCapacity` takes another
+    // one if the app knows better.
+    static constexpr size_t MAX_PUSH_SIZE = 76'800;
+
+    // Returns the size push() would return, without compressing or encrypting anything: exact if
+    // the last push() result is still valid, otherwise an approximation (normally an upper bound,
+    // as compression can only make the real size smaller) computed from a dump of the config.
+    // That still costs a dump, once per change.  `exact`, if given, is set to whether the size is
+    // exact.
+    size_t estimatePushSizeConfig(bool* exact = nullptr);
+
+    // Native versions of `storageNamespace`, `needsPush`, `needsDump`, `push`, `dump`, `merge` and
+    // `confirmPushed`, for the static functions operating on several wrappers at once and the
+    // wrappers combining several configs.  `pushConfig` does not touch any JS value (not even the
+    // status block), and so can be called off the main thread (as long as nothing else uses this
+    // wrapper meanwhile); the caller then calls `updateStatus()`.
+    uint16_t storageNamespaceConfig();
+    bool needsPushConfig();
+    bool needsDumpConfig();
+    std::tuple<config::seqno_t, ustring, std::vector<std::string>> pushConfig();
+    ustring dumpConfig();
+    std::vector<std::string> mergeConfig(
+            const std::vector<std::pair<std::string, ustring_view>>& conf_strs) {
+        return mergeMessages(conf_strs);
+    }
+    void confirmPushedConfig(config::seqno_t seqno, const std::string& hash);
+
+    // Brings the status block up to date with the config.  JS thread only.
+    void updateStatus();
+
+    // Approximate native memory held by a wrapper: the entries of each collection of its config
+    // (with the size of their data), and what the wrapper itself keeps on top of the config.
+    struct CollectionUsage {
+        std::string name;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+    struct MemoryUsage {
+        std::vector<CollectionUsage> collections;
+        size_t push_cache = 0;
+        size_t seen_hashes = 0;
+        size_t transactions = 0;
+        size_t snapshot = 0;
+        size_t ingest_buffer = 0;
+
+        size_t total() const;
+    };
+    MemoryUsage memoryUsageConfig();
+
+    // Drops the caches which can be recomputed (the push cache and last snapshot), and shrinks the
+    // seen hashes.  The config itself is unchanged.  Returns how many bytes that freed, as measured
+    // by the allocator where it can tell (glibc: process-wide, so the allocations other threads
+    // made meanwhile count too), and as estimated by `memoryUsageConfig` otherwise.
+    size_t compactConfig();
+
+    // Changes whenever the config data changes (locally, through a merge, a rollback or a restore),
+    // so that native code deriving state from it can tell when that state needs refreshing.
+    uint32_t changeCount() const { return mutation_count_; }
+
+    // The wrappers of any type alive in the JS environment of the calling thread.
+    static const std::unordered_set<ConfigBaseImpl*>& liveWrappers() { return live_wrappers_; }
+
+    // Writes out the libsession log lines this wrapper's config emitted from other threads since
+    // the last call (those can only be logged from the JS thread).
+    void flushPendingLogs() {
+        if (logs_)
+            logs_->flush();
+    }
+
+    // Transactions, which can be nested: changes made until the matching commit only notify the
+    // `onChange` listener and persist scheduler once, at the commit of the outermost transaction.
+    // A rollback reverts the config to how it was at the matching begin (if it changed since).
+    // Throws std::logic_error if this wrapper's config can't be reloaded.
+    void beginTransaction();
+    void commitTransaction();
+    void rollbackTransaction();
+
   protected:
+    // What `construct` returns: the config, the function building another one from a dump, and
+    // what the wrapper needs to report its native size to V8 (see ExternalMemory): the
+    // environment, and an initial estimate of that size.
+    struct Constructed {
+        std::shared_ptr<session::config::ConfigBase> conf;
+        std::function<std::shared_ptr<config::ConfigBase>(ustring_view dump)> rebuild;
+        std::shared_ptr<LogQueue> logs;
+        napi_env env = nullptr;
+        size_t initial_size = 0;
+    };
+
     // Constructor (callable from a subclass): the wrapper subclass constructs its
     // ConfigBase-derived shared_ptr during *its* construction, passing it here.  For example:
     //
     //     ConfigWhateverWrapper(const Napi::CallbackInfo& info) :
     //         ConfigBaseImpl{construct<config::Whatever>(info), "Whatever"},
     //         Napi::ObjectWrap<UserWhateverWrapper>{info} {}
-    ConfigBaseImpl(std::shared_ptr<session::config::ConfigBase> conf) : conf_{std::move(conf)} {
+    ConfigBaseImpl(
+            std::shared_ptr<session::config::ConfigBase> conf,
+            napi_env env = nullptr,
+            size_t initial_size = 0) :
+            conf_{std::move(conf)}, external_memory_{env, initial_size} {
         if (!conf_)
             throw std::invalid_argument{
                     "ConfigBaseImpl initialization requires a live ConfigBase pointer"};
+        live_wrappers_.insert(this);
+    }
+
+    // The subclass isn't constructed yet, so its collections can't be measured: the reported size
+    // starts from the size of the dump, which is corrected by the first merge or enough changes.
+    ConfigBaseImpl(Constructed constructed) :
+            ConfigBaseImpl{
+                    std::move(constructed.conf), constructed.env, constructed.initial_size} {
+        rebuild_ = std::move(constructed.rebuild);
+        logs_ = std::move(constructed.logs);
     }
 
     // Constructs a shared_ptr of some config::ConfigBase-derived type, taking a secret key and
     // optional dump.  This is what most Config types require, but a subclass could replace this if
     // it needs to do something else.
+    //
+    // Reloading the config (for a rollback, restore or compaction) builds a new one from a dump;
+    // for that, a copy of the secret key is kept (and wiped on destruction).
     template <
             typename Config,
             std::enable_if_t<std::is_base_of_v<config::ConfigBase, Config>, int> = 0>
-    static std::shared_ptr<Config> construct(
+    static Constructed construct(
             const Napi::CallbackInfo& info, const std::string& class_name) {
         return wrapExceptions(info, [&] {
             if (!info.IsConstructCall())
@@ -103,29 +385,91 @@ class ConfigBaseImpl {
             std::shared_ptr<Config> config = std::make_shared<Config>(secretKey, dump);
 
             Napi::Env env = info.Env();
+            auto logs = std::make_shared<LogQueue>(env);
 
-            config->logger = [env, class_name](session::config::LogLevel, std::string_view x) {
-                std::string toLog =
-                        "libsession-util:" + std::string(class_name) + ": " + std::string(x) + "\n";
+            config->logger = [logs, class_name](session::config::LogLevel, std::string_view x) {
+                logs->log("libsession-util:" + std::string(class_name) + ": " + std::string(x) +
+                          "\n");
+            };
 
-                Napi::Function consoleLog = env.Global()
-                                                    .Get("console")
-                                                    .As<Napi::Object>()
-                                                    .Get("log")
-                                                    .As<Napi::Function>();
-                consoleLog.Call({Napi::String::New(env, toLog)});
+            std::shared_ptr<ustring> sk{new ustring{secretKey}, [](ustring* sk) {
+                                            sodium_memzero(sk->data(), sk->size());
+                                            delete sk;
+                                        }};
+            auto rebuild = [sk](ustring_view dump) -> std::shared_ptr<config::ConfigBase> {
+                return std::make_shared<Config>(*sk, dump);
             };
 
-            return config;
+            return Constructed{
+                    std::move(config),
+                    std::move(rebuild),
+                    std::move(logs),
+                    env,
+                    dump ? dump->size() : 0};
         });
     }
 
-    virtual ~ConfigBaseImpl() = default;
+    // Tags the JS object under construction as a `T`; wrapper constructors call this so that
+    // their instances can be passed to `unwrapConfig<T>()`.
+    template <typename T, std::enable_if_t<is_derived_napi_wrapper<T>, int> = 0>
+    static void tagInstance(const Napi::CallbackInfo& info) {
+        info.This().As<Napi::Object>().TypeTag(wrapper_type_tag<T>());
+    }
+
+    virtual ~ConfigBaseImpl();
+
+    // What caused a call to `mutated()`, as reported to the `onChange` listener
+    using ChangeKind = session::nodeapi::ChangeKind;
+
+    // Must be called by every method changing the config's data, after doing so: drops what was
+    // cached from it (such as the last push() result) and notifies the `onChange` listener.
+    // `merge` and `confirmPushed` call it themselves; the subclass setters use a `Mutation`.
+    void mutated(ChangeKind kind = ChangeKind::local);
+
+    // Scope guard for the subclass methods changing the config's data, to construct just before
+    // the first change.  The cached push() result is dropped right away, so that it never
+    // outlives a change, even one made by a method throwing part way through; `mutated()` is then
+    // called when the guard goes out of scope, whether the method completed or not.
+    class Mutation {
+      public:
+        explicit Mutation(ConfigBaseImpl& impl, ChangeKind kind = ChangeKind::local) :
+                impl_{impl}, kind_{kind} {
+            impl_.push_cache_.invalidate();
+        }
+
+        ~Mutation() {
+            try {
+                impl_.mutated(kind_);
+            } catch (const std::exception&) {
+                // The change itself was made: only the notification of it failed
+            }
+        }
+
+        Mutation(const Mutation&) = delete;
+        Mutation& operator=(const Mutation&) = delete;
+
+      private:
+        ConfigBaseImpl& impl_;
+        ChangeKind kind_;
+    };
+
+    // Reports the collections of the subclass' config (e.g. contacts), for `memoryUsage()`.
+    virtual std::vector<CollectionUsage> collectionUsage() { return {}; }
+
+    // Called after the `onChange` listener and persist scheduler were notified of a change (or of
+    // the changes of a whole transaction), for subclasses persisting the config along with others.
+    virtual void changeNotified() {}
+
+    // Called after the config data changed other than through the subclass' own setters: when
+    // `merge` applied incoming messages, or a transaction was rolled back.  Subclasses keeping
+    // state derived from the config data (such as a search index) override this to refresh it.
+    virtual void onExternalChange() {}
 
     // Accesses a reference the stored config instance as `std::shared_ptr<T>` (if no template is
     // specified then as the base ConfigBase type).  `T` must be a subclass of ConfigBase for this
     // to compile.  Throws std::logic_error if not set.  Throws std::invalid_argument if the
-    // instance is not castable to a `T`.
+    // instance is not castable to a `T`.  The reference must not be kept: reloading the config
+    // (see `construct`) replaces the instance.
     template <typename T, std::enable_if_t<std::is_base_of_v<config::ConfigBase, T>, int> = 0>
     T& get_config() {
         assert(conf_);  // should not be possible to construct without this set
@@ -168,4 +512,11 @@ class ConfigBaseImpl {
     }
 };
 
+// `{collections: {[name]: {entries, bytes}}, pushCache, seenHashes, transactions, snapshot,
+// ingestBuffer, total}`, all in bytes apart from the entry counts.
+template <>
+struct toJs_impl<ConfigBaseImpl::MemoryUsage> {
+    Napi::Object operator()(const Napi::Env& env, const ConfigBaseImpl::MemoryUsage& usage);
+};
+
 }  // namespace session::nodeapi
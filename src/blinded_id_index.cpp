@@ -0,0 +1,150 @@
+#include "blinded_id_index.hpp"
+
+#include <sodium/core.h>
+
+#include "base_config.hpp"
+#include "contacts_config.hpp"
+#include "meta/meta_base_wrapper.hpp"
+#include "parallel.hpp"
+#include "session/blinding.hpp"
+#include "user_groups_config.hpp"
+
+namespace session::nodeapi {
+
+void BlindedIdIndexWrapper::Init(Napi::Env env, Napi::Object exports) {
+    if (sodium_init() < 0)
+        throw std::runtime_error{"BlindedIdIndexWrapper: failed to initialize libsodium"};
+
+    MetaBaseWrapper::NoBaseClassInitHelper<BlindedIdIndexWrapper>(
+            env,
+            exports,
+            "BlindedIdIndexNode",
+            {
+                    InstanceMethod("refresh", &BlindedIdIndexWrapper::refresh),
+                    InstanceMethod("lookupBlinded", &BlindedIdIndexWrapper::lookupBlinded),
+                    InstanceMethod("size", &BlindedIdIndexWrapper::size),
+            });
+}
+
+BlindedIdIndexWrapper::BlindedIdIndexWrapper(const Napi::CallbackInfo& info) :
+        Napi::ObjectWrap<BlindedIdIndexWrapper>{info} {
+    wrapExceptions(info, [&] {
+        if (!info.IsConstructCall())
+            throw std::invalid_argument{"You need to call the constructor with the `new` syntax"};
+        assertInfoLength(info, 2);
+
+        // Make sure we were given the right wrappers before keeping a reference to them
+        ConfigBaseImpl::unwrapConfig<UserGroupsWrapper, config::UserGroups>(
+                info[0], "BlindedIdIndex.new userGroups");
+        ConfigBaseImpl::unwrapConfig<ContactsConfigWrapper, config::Contacts>(
+                info[1], "BlindedIdIndex.new contacts");
+        user_groups_ = Napi::Persistent(info[0].As<Napi::Object>());
+        contacts_ = Napi::Persistent(info[1].As<Napi::Object>());
+
+        // Force the first update
+        user_groups_changes_ = contacts_changes_ = ~uint32_t{0};
+        update();
+    });
+}
+
+size_t BlindedIdIndexWrapper::update() {
+    auto& user_groups_impl = ConfigBaseImpl::unwrapImpl<UserGroupsWrapper>(
+            user_groups_.Value(), "BlindedIdIndex userGroups");
+    auto& contacts_impl = ConfigBaseImpl::unwrapImpl<ContactsConfigWrapper>(
+            contacts_.Value(), "BlindedIdIndex contacts");
+    if (user_groups_impl.changeCount() == user_groups_changes_ &&
+        contacts_impl.changeCount() == contacts_changes_)
+        return 0;
+
+    auto& user_groups = ConfigBaseImpl::unwrapConfig<UserGroupsWrapper, config::UserGroups>(
+            user_groups_.Value(), "BlindedIdIndex userGroups");
+    auto& contacts = ConfigBaseImpl::unwrapConfig<ContactsConfigWrapper, config::Contacts>(
+            contacts_.Value(), "BlindedIdIndex contacts");
+
+    // Several rooms usually live on the same server, and so share the same pubkey
+    std::set<std::string> servers;
+    for (auto it = user_groups.begin_communities(); it != user_groups.end(); it++) {
+        const config::community_info& community = *it;
+        servers.insert(community.pubkey_hex());
+    }
+
+    std::set<std::string> session_ids;
+    for (const auto& contact : contacts)
+        if (contact.session_id.size() == 66 && contact.session_id.compare(0, 2, "05") == 0)
+            session_ids.insert(contact.session_id);
+
+    // Drop the pairs whose contact or server is gone
+    for (auto it = by_pair_.begin(); it != by_pair_.end();) {
+        if (session_ids.count(it->first.first) && servers.count(it->first.second)) {
+            ++it;
+            continue;
+        }
+        for (const auto& blinded : it->second)
+            by_blinded_.erase(blinded);
+        it = by_pair_.erase(it);
+    }
+
+    std::vector<std::pair<const std::string*, const std::string*>> todo;
+    for (const auto& session_id : session_ids)
+        for (const auto& server : servers)
+            if (!by_pair_.count({session_id, server}))
+                todo.emplace_back(&session_id, &server);
+
+    // This is where the actual (expensive) work happens, so spread it over all the cores
+    std::vector<std::vector<std::string>> blinded(todo.size());
+    parallel_for(
+            todo.size(),
+            [&](size_t i) {
+                auto [session_id, server] = todo[i];
+                auto [b15_pos, b15_neg] = session::blind15_id(*session_id, *server);
+                blinded[i] = {
+                        std::move(b15_pos),
+                        std::move(b15_neg),
+                        session::blind25_id(*session_id, *server)};
+            },
+            16);
+
+    for (size_t i = 0; i < todo.size(); i++) {
+        auto [session_id, server] = todo[i];
+        for (const auto& b : blinded[i])
+            by_blinded_[b] = Entry{*session_id, *server};
+        by_pair_.emplace(std::make_pair(*session_id, *server), std::move(blinded[i]));
+    }
+
+    user_groups_changes_ = user_groups_impl.changeCount();
+    contacts_changes_ = contacts_impl.changeCount();
+    return todo.size();
+}
+
+Napi::Value BlindedIdIndexWrapper::refresh(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return update();
+    });
+}
+
+Napi::Value BlindedIdIndexWrapper::lookupBlinded(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&]() -> Napi::Value {
+        auto blinded_id = getStringArgs<1>(info);
+        update();
+        auto it = by_blinded_.find(blinded_id);
+        if (it == by_blinded_.end())
+            return env.Null();
+
+        auto obj = Napi::Object::New(env);
+        obj["sessionId"] = toJs(env, it->second.session_id);
+        obj["serverPubkeyHex"] = toJs(env, it->second.server_pk);
+        return obj;
+    });
+}
+
+Napi::Value BlindedIdIndexWrapper::size(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        update();
+        return by_blinded_.size();
+    });
+}
+
+}  // namespace session::nodeapi
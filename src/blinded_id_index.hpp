@@ -0,0 +1,55 @@
+#pragma once
+
+#include <napi.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace session::nodeapi {
+
+/// Reverse index from the blinded (15- and 25-prefixed) ids of our contacts on each of the
+/// communities we are part of, back to the contacts' session ids.
+///
+/// It is constructed from a UserGroupsWrapper and a ContactsConfigWrapper (which it keeps a
+/// reference to), and follows their changes: every call first updates the index if either of them
+/// changed since the last update (as told by their `changeCount()`), only computing the blinded ids
+/// for the (contact, server) pairs which were not indexed yet.  The blinding itself is spread over
+/// the `parallel_for` thread pool.
+class BlindedIdIndexWrapper : public Napi::ObjectWrap<BlindedIdIndexWrapper> {
+  public:
+    static void Init(Napi::Env env, Napi::Object exports);
+
+    explicit BlindedIdIndexWrapper(const Napi::CallbackInfo& info);
+
+  private:
+    struct Entry {
+        std::string session_id;
+        std::string server_pk;
+    };
+
+    Napi::ObjectReference user_groups_;
+    Napi::ObjectReference contacts_;
+
+    // blinded id -> (session id, server pubkey)
+    std::unordered_map<std::string, Entry> by_blinded_;
+    // (session id, server pubkey) -> the blinded ids of that pair
+    std::map<std::pair<std::string, std::string>, std::vector<std::string>> by_pair_;
+
+    // The `changeCount()` of the wrappers when the index was last updated
+    uint32_t user_groups_changes_ = 0;
+    uint32_t contacts_changes_ = 0;
+
+    // Updates the index if either wrapper changed since the last update; returns the number of
+    // (contact, server) pairs computed.
+    size_t update();
+
+    Napi::Value refresh(const Napi::CallbackInfo& info);
+    Napi::Value lookupBlinded(const Napi::CallbackInfo& info);
+    Napi::Value size(const Napi::CallbackInfo& info);
+};
+
+}  // namespace session::nodeapi
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <napi.h>
+#include <sodium/utils.h>
 
 #include <algorithm>
 
@@ -51,17 +52,15 @@ class BlindingWrapper : public Napi::ObjectWrap<BlindingWrapper> {
                 throw std::invalid_argument("blindVersionPubkey received empty");
 
             assertIsUInt8Array(obj.Get("ed25519SecretKey"));
-            auto ed25519_secret_key =
-                    toCppBuffer(obj.Get("ed25519SecretKey"), "blindVersionPubkey.ed25519SecretKey");
+            auto ed25519_secret_key = toCppBufferView(
+                    obj.Get("ed25519SecretKey"), "blindVersionPubkey.ed25519SecretKey");
 
-            auto keypair = session::blind_version_key_pair(ed25519_secret_key);
-            session::uc32 pk_arr = std::get<0>(keypair);
-            ustring blinded_pk = session::ustring(
-                    session::to_unsigned_sv(std::string(pk_arr.begin(), pk_arr.end())));
+            auto [pk_arr, sk_arr] = session::blind_version_key_pair(ed25519_secret_key);
+            sodium_memzero(sk_arr.data(), sk_arr.size());
             std::string blinded_pk_hex;
             blinded_pk_hex.reserve(66);
             blinded_pk_hex += "07";
-            oxenc::to_hex(blinded_pk.begin(), blinded_pk.end(), std::back_inserter(blinded_pk_hex));
+            oxenc::to_hex(pk_arr.begin(), pk_arr.end(), std::back_inserter(blinded_pk_hex));
 
             return blinded_pk_hex;
         });
@@ -77,8 +76,8 @@ class BlindingWrapper : public Napi::ObjectWrap<BlindingWrapper> {
                 throw std::invalid_argument("blindVersionSign received empty");
 
             assertIsUInt8Array(obj.Get("ed25519SecretKey"));
-            auto ed25519_secret_key =
-                    toCppBuffer(obj.Get("ed25519SecretKey"), "blindVersionSign.ed25519SecretKey");
+            auto ed25519_secret_key = toCppBufferView(
+                    obj.Get("ed25519SecretKey"), "blindVersionSign.ed25519SecretKey");
 
             assertIsNumber(obj.Get("sigTimestampSeconds"));
             auto sig_timestamp = toCppInteger(
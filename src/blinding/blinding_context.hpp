@@ -0,0 +1,129 @@
+#pragma once
+
+#include <napi.h>
+#include <sodium/crypto_sign_ed25519.h>
+#include <sodium/utils.h>
+
+#include <string>
+
+#include "../meta/meta_base_wrapper.hpp"
+#include "../utilities.hpp"
+#include "oxenc/hex.h"
+#include "session/blinding.hpp"
+#include "session/platform.hpp"
+
+namespace session::nodeapi {
+
+/// Holds the blinded version keypair derived from an ed25519 secret key, so that it is derived
+/// once rather than on every call to `BlindingWrapper.blindVersionPubkey`/`blindVersionSign`.
+class BlindingContextWrapper : public Napi::ObjectWrap<BlindingContextWrapper> {
+
+  public:
+    BlindingContextWrapper(const Napi::CallbackInfo& info) :
+            Napi::ObjectWrap<BlindingContextWrapper>{info} {
+        wrapExceptions(info, [&] {
+            if (!info.IsConstructCall())
+                throw std::invalid_argument{
+                        "You need to call the constructor with the `new` syntax"};
+            assertInfoLength(info, 1);
+            assertIsObject(info[0]);
+            auto obj = info[0].As<Napi::Object>();
+
+            assertIsUInt8Array(obj.Get("ed25519SecretKey"));
+            auto ed25519_sk = toCppBuffer(
+                    obj.Get("ed25519SecretKey"), "BlindingContext.new.ed25519SecretKey");
+
+            // Only the derived keypair is kept: the secret key itself is wiped as soon as possible
+            try {
+                std::tie(blinded_pk_, blinded_sk_) = session::blind_version_key_pair(ed25519_sk);
+            } catch (...) {
+                sodium_memzero(ed25519_sk.data(), ed25519_sk.size());
+                throw;
+            }
+            sodium_memzero(ed25519_sk.data(), ed25519_sk.size());
+
+            blinded_pk_hex_.reserve(66);
+            blinded_pk_hex_ += "07";
+            oxenc::to_hex(
+                    blinded_pk_.begin(), blinded_pk_.end(), std::back_inserter(blinded_pk_hex_));
+        });
+    }
+
+    ~BlindingContextWrapper() {
+        sodium_memzero(blinded_sk_.data(), blinded_sk_.size());
+    }
+
+    static void Init(Napi::Env env, Napi::Object exports) {
+        MetaBaseWrapper::NoBaseClassInitHelper<BlindingContextWrapper>(
+                env,
+                exports,
+                "BlindingContextNode",
+                {
+                        InstanceMethod(
+                                "blindVersionPubkey", &BlindingContextWrapper::blindVersionPubkey),
+                        InstanceMethod(
+                                "blindVersionSign", &BlindingContextWrapper::blindVersionSign),
+                        InstanceMethod("signMany", &BlindingContextWrapper::signMany),
+                });
+    }
+
+  private:
+    session::uc32 blinded_pk_;
+    session::uc64 blinded_sk_;
+    std::string blinded_pk_hex_;
+
+    // Same as `session::blind_version_sign(ed25519_sk, Platform::desktop, timestamp)`, i.e. a
+    // signature of `TIMESTAMP || METHOD || PATH`, but without re-deriving the blinded keypair.
+    // libsession has no API signing with an already derived key, so the signed message is built
+    // here; test/blinding.test.js checks that it still matches libsession's.
+    ustring sign(uint64_t timestamp) const {
+        std::string msg = std::to_string(timestamp);
+        msg += "GET/session_version?platform=desktop";
+
+        ustring sig;
+        sig.resize(64);
+        if (0 != crypto_sign_ed25519_detached(
+                         sig.data(),
+                         nullptr,
+                         reinterpret_cast<const unsigned char*>(msg.data()),
+                         msg.size(),
+                         blinded_sk_.data()))
+            throw std::runtime_error{"BlindingContext: failed to sign"};
+        return sig;
+    }
+
+    Napi::Value blindVersionPubkey(const Napi::CallbackInfo& info) {
+        return wrapResult(info, [&] {
+            assertInfoLength(info, 0);
+            return blinded_pk_hex_;
+        });
+    }
+
+    Napi::Value blindVersionSign(const Napi::CallbackInfo& info) {
+        return wrapResult(info, [&] {
+            assertInfoLength(info, 1);
+            assertIsNumber(info[0]);
+            return sign(toCppInteger(info[0], "BlindingContext.blindVersionSign", false));
+        });
+    }
+
+    Napi::Value signMany(const Napi::CallbackInfo& info) {
+        auto env = info.Env();
+        return wrapExceptions(env, [&] {
+            assertInfoLength(info, 1);
+            assertIsArray(info[0]);
+            auto timestamps = info[0].As<Napi::Array>();
+
+            BufferSlab slab{env, timestamps.Length() * 64};
+            auto sigs = Napi::Array::New(env, timestamps.Length());
+            for (uint32_t i = 0; i < timestamps.Length(); i++) {
+                auto ts = timestamps.Get(i);
+                assertIsNumber(ts);
+                sigs[i] = slab.view(sign(toCppInteger(ts, "BlindingContext.signMany", false)));
+            }
+            return sigs;
+        });
+    }
+};
+
+}  // namespace session::nodeapi
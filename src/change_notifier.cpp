@@ -0,0 +1,63 @@
+#include "change_notifier.hpp"
+
+#include "utilities.hpp"
+
+namespace session::nodeapi {
+
+struct ChangeNotifier::State {
+    Napi::ThreadSafeFunction tsfn;
+    uint16_t storage_namespace;
+    // Only accessed from the JS thread:
+    bool pending = false;
+    uint8_t kinds = 0;
+    bool needs_push = false;
+    bool needs_dump = false;
+};
+
+ChangeNotifier::ChangeNotifier(
+        Napi::Env env, Napi::Function listener, uint16_t storage_namespace) :
+        state_{std::make_shared<State>()} {
+    state_->storage_namespace = storage_namespace;
+    state_->tsfn =
+            Napi::ThreadSafeFunction::New(env, listener, "libsession-util onChange", 0, 1);
+    // A listener must not keep the process alive
+    state_->tsfn.Unref(env);
+}
+
+ChangeNotifier::~ChangeNotifier() {
+    state_->tsfn.Release();
+}
+
+void ChangeNotifier::notify(uint8_t kinds, bool needs_push, bool needs_dump) {
+    auto& state = *state_;
+    state.kinds |= kinds;
+    state.needs_push = needs_push;
+    state.needs_dump = needs_dump;
+    if (state.pending)
+        return;
+
+    // The call only runs once the current JS task is done, so every change made until then is
+    // reported by that one call.
+    state.pending = true;
+    state.tsfn.NonBlockingCall([state = state_](Napi::Env env, Napi::Function callback) {
+        auto kinds = Napi::Array::New(env);
+        if (state->kinds & static_cast<uint8_t>(ChangeKind::local))
+            kinds[kinds.Length()] = Napi::String::New(env, "local");
+        if (state->kinds & static_cast<uint8_t>(ChangeKind::merge))
+            kinds[kinds.Length()] = Napi::String::New(env, "merge");
+        if (state->kinds & static_cast<uint8_t>(ChangeKind::confirmPushed))
+            kinds[kinds.Length()] = Napi::String::New(env, "confirmPushed");
+
+        auto change = Napi::Object::New(env);
+        change["namespace"] = toJs(env, state->storage_namespace);
+        change["kinds"] = kinds;
+        change["needsPush"] = toJs(env, state->needs_push);
+        change["needsDump"] = toJs(env, state->needs_dump);
+
+        state->pending = false;
+        state->kinds = 0;
+        callback.Call({change});
+    });
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <napi.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace session::nodeapi {
+
+// What changed a config, as reported to the `onChange` listener
+enum class ChangeKind : uint8_t {
+    local = 1 << 0,
+    merge = 1 << 1,
+    confirmPushed = 1 << 2,
+};
+
+/// The listener a wrapper's `onChange` sets: called once the current JS task is done (so once per
+/// tick at most) after the config changed, with every change made until then, as
+/// `{namespace, kinds, needsPush, needsDump}`.  It does not keep the process alive.
+class ChangeNotifier {
+  public:
+    ChangeNotifier(Napi::Env env, Napi::Function listener, uint16_t storage_namespace);
+    ~ChangeNotifier();
+
+    ChangeNotifier(const ChangeNotifier&) = delete;
+    ChangeNotifier& operator=(const ChangeNotifier&) = delete;
+
+    // `kinds` is a combination of ChangeKind; `needs_push` and `needs_dump` are the config's
+    // state after the change.
+    void notify(uint8_t kinds, bool needs_push, bool needs_dump);
+
+  private:
+    // Shared with the call queued on the thread-safe function, which can outlive the notifier
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace session::nodeapi
@@ -1,20 +1,47 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "query.hpp"
 #include "session/config/community.hpp"
 #include "utilities.hpp"
 
 namespace session::nodeapi {
 
-template <>
-struct toJs_impl<config::community> {
-    Napi::Object operator()(const Napi::Env& env, const config::community info_comm) {
-        auto obj = Napi::Object::New(env);
+// The fields of the JS object of a community, as stored by the different configs (which derive
+// their community records from config::community), followed by the config's own `extra` fields.
+template <typename Community>
+QueryFields<Community> community_query_fields(std::initializer_list<QueryField<Community>> extra) {
+    QueryFields<Community> fields{
+            {"fullUrlWithPubkey", [](const Community& c) -> FieldValue { return c.full_url(); }},
+            {"baseUrl", [](const Community& c) -> FieldValue { return std::string{c.base_url()}; }},
+            {"roomCasePreserved",
+             [](const Community& c) -> FieldValue { return std::string{c.room()}; }},
+            {"pubkeyHex", [](const Community& c) -> FieldValue { return c.pubkey_hex(); }},
+    };
+    fields.insert(fields.end(), extra);
+    return fields;
+}
+
+// What libsession orders the communities of a config by: the base url, then the lowercase room.
+using CommunityKey = std::pair<std::string_view, std::string_view>;
 
-        obj["fullUrlWithPubkey"] = toJs(env, info_comm.full_url());
-        obj["baseUrl"] = toJs(env, info_comm.base_url());
-        obj["roomCasePreserved"] = toJs(env, info_comm.room());
-        obj["pubkeyHex"] = toJs(env, info_comm.pubkey_hex());
+template <typename Community>
+CommunityKey community_key(const Community& c) {
+    return {c.base_url(), c.room_norm()};
+}
 
-        return obj;
-    }
-};
+// The lowercase room libsession keys a community by (its `room_norm()`): only ASCII letters are
+// lowered.
+inline std::string community_room_norm(std::string_view room) {
+    std::string norm{room};
+    for (auto& c : norm)
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+    return norm;
+}
 
 }  // namespace session::nodeapi
@@ -0,0 +1,489 @@
+#include "config_actor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "contacts_config.hpp"
+#include "log_queue.hpp"
+#include "meta/meta_base_wrapper.hpp"
+#include "session/config/base.hpp"
+#include "session/config/contacts.hpp"
+#include "session/config/convo_info_volatile.hpp"
+#include "session/config/user_groups.hpp"
+#include "session/config/user_profile.hpp"
+#include "utilities.hpp"
+
+namespace session::nodeapi {
+
+using config::ConfigBase;
+
+// Only ever accessed from the actor thread once it started
+struct ConfigActorWrapper::Configs {
+    std::vector<std::unique_ptr<ConfigBase>> configs;
+
+    ConfigBase& get(uint16_t ns) {
+        for (auto& conf : configs)
+            if (static_cast<uint16_t>(conf->storage_namespace()) == ns)
+                return *conf;
+        throw std::invalid_argument{"ConfigActor: no config with namespace " + std::to_string(ns)};
+    }
+
+    template <typename Config>
+    Config& get() {
+        for (auto& conf : configs)
+            if (auto* c = dynamic_cast<Config*>(conf.get()))
+                return *c;
+        throw std::logic_error{"ConfigActor: missing config"};
+    }
+};
+
+namespace {
+
+    struct Command {
+        Command* next = nullptr;
+        // Empty for the command stopping the thread
+        std::function<ConfigActorWrapper::Result(ConfigActorWrapper::Configs&)> run;
+        // Empty when nobody waits for the result
+        std::optional<Napi::Promise::Deferred> deferred;
+
+        ConfigActorWrapper::Result result;
+        std::optional<std::string> error;
+    };
+
+}  // namespace
+
+struct ConfigActorWrapper::Actor {
+    Configs configs;
+    std::thread thread;
+    bool closed = false;
+
+    // The log lines of the configs, written out on the JS thread along with each batch's results
+    std::shared_ptr<LogQueue> logs;
+
+    // Hands the results of each batch back to the JS thread.  It is only ref'd while commands are
+    // outstanding, so that an idle actor does not keep the process alive.  The actor thread holds
+    // the only thread count, and releases it once it stopped.
+    Napi::ThreadSafeFunction tsfn;
+    size_t outstanding = 0;  // only accessed from the JS thread
+
+    // The command queue: a lock-free stack, which the actor thread empties all at once (and
+    // reverses to get the commands in order).  The mutex and condition variable are only used to
+    // wait for commands while the queue is empty.
+    std::atomic<Command*> head{nullptr};
+    std::atomic<bool> sleeping{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+
+    // Can be called from any thread
+    void push(Command* cmd) {
+        cmd->next = head.load();
+        while (!head.compare_exchange_weak(cmd->next, cmd))
+            ;
+        if (sleeping.load()) {
+            std::lock_guard lock{wake_mutex};
+            wake_cv.notify_one();
+        }
+    }
+
+    // Waits for commands, and returns them in the order they were pushed.
+    std::vector<std::unique_ptr<Command>> take() {
+        Command* list = head.exchange(nullptr);
+        if (!list) {
+            std::unique_lock lock{wake_mutex};
+            sleeping = true;
+            wake_cv.wait(lock, [this] { return head.load() != nullptr; });
+            sleeping = false;
+            list = head.exchange(nullptr);
+        }
+
+        std::vector<std::unique_ptr<Command>> batch;
+        for (; list; list = list->next)
+            batch.emplace_back(list);
+        std::reverse(batch.begin(), batch.end());
+        return batch;
+    }
+
+    // The actor thread: runs the commands, handing back the results of each batch at once.
+    void run(std::shared_ptr<Actor> self) {
+        for (bool stop = false; !stop;) {
+            auto batch = take();
+            for (auto& cmd : batch) {
+                if (!cmd->run) {
+                    stop = true;
+                    continue;
+                }
+                try {
+                    cmd->result = cmd->run(configs);
+                } catch (const std::exception& e) {
+                    cmd->error = e.what();
+                } catch (...) {
+                    cmd->error = "ConfigActor: unknown exception";
+                }
+            }
+
+            tsfn.NonBlockingCall([self, batch = std::make_shared<decltype(batch)>(
+                                                std::move(batch))](Napi::Env env, Napi::Function) {
+                self->settle(env, *batch);
+            });
+        }
+        tsfn.Release();
+    }
+
+    // On the JS thread: resolves or rejects the promises of a batch.
+    void settle(Napi::Env env, std::vector<std::unique_ptr<Command>>& batch) {
+        logs->flush();
+        for (auto& cmd : batch) {
+            if (!cmd->deferred)
+                continue;
+            outstanding--;
+            if (!cmd->error) {
+                try {
+                    cmd->deferred->Resolve(cmd->result ? cmd->result(env) : env.Undefined());
+                    continue;
+                } catch (const std::exception& e) {
+                    cmd->error = e.what();
+                }
+            }
+            cmd->deferred->Reject(Napi::Error::New(env, *cmd->error).Value());
+        }
+
+        if (outstanding == 0)
+            tsfn.Unref(env);
+    }
+};
+
+void ConfigActorWrapper::Init(Napi::Env env, Napi::Object exports) {
+    MetaBaseWrapper::NoBaseClassInitHelper<ConfigActorWrapper>(
+            env,
+            exports,
+            "ConfigActorNode",
+            {
+                    InstanceMethod("needsPush", &ConfigActorWrapper::needsPush),
+                    InstanceMethod("needsDump", &ConfigActorWrapper::needsDump),
+                    InstanceMethod("push", &ConfigActorWrapper::push),
+                    InstanceMethod("pushAll", &ConfigActorWrapper::pushAll),
+                    InstanceMethod("dump", &ConfigActorWrapper::dump),
+                    InstanceMethod("confirmPushed", &ConfigActorWrapper::confirmPushed),
+                    InstanceMethod("merge", &ConfigActorWrapper::merge),
+                    InstanceMethod("getUserName", &ConfigActorWrapper::getUserName),
+                    InstanceMethod("setUserName", &ConfigActorWrapper::setUserName),
+                    InstanceMethod("getContact", &ConfigActorWrapper::getContact),
+                    InstanceMethod("getAllContacts", &ConfigActorWrapper::getAllContacts),
+                    InstanceMethod("setContact", &ConfigActorWrapper::setContact),
+                    InstanceMethod("eraseContact", &ConfigActorWrapper::eraseContact),
+                    InstanceMethod("close", &ConfigActorWrapper::close),
+            });
+}
+
+ConfigActorWrapper::ConfigActorWrapper(const Napi::CallbackInfo& info) :
+        Napi::ObjectWrap<ConfigActorWrapper>{info} {
+    wrapExceptions(info, [&] {
+        if (!info.IsConstructCall())
+            throw std::invalid_argument{"You need to call the constructor with the `new` syntax"};
+        assertInfoLength(info, 2);
+        assertIsUInt8Array(info[0]);
+        assertIsObject(info[1]);
+        ustring_view secret_key = toCppBufferView(info[0], "ConfigActor.new");
+        auto dumps = info[1].As<Napi::Object>();
+
+        auto env = info.Env();
+        actor_ = std::make_shared<Actor>();
+        actor_->logs = std::make_shared<LogQueue>(env);
+        auto& configs = actor_->configs.configs;
+
+        auto add = [&](auto tag, const char* key) {
+            using Config = typename decltype(tag)::type;
+            std::optional<ustring_view> dump;
+            if (auto val = dumps.Get(key); !val.IsNull() && !val.IsUndefined())
+                dump = toCppBufferView(val, std::string{"ConfigActor.new."} + key);
+
+            auto& conf = configs.emplace_back(std::make_unique<Config>(secret_key, dump));
+            conf->logger = [logs = actor_->logs, key](config::LogLevel, std::string_view x) {
+                logs->log(
+                        "libsession-util:ConfigActor:" + std::string{key} + ": " + std::string{x} +
+                        "\n");
+            };
+        };
+        add(std::common_type<config::UserProfile>{}, "userProfile");
+        add(std::common_type<config::Contacts>{}, "contacts");
+        add(std::common_type<config::UserGroups>{}, "userGroups");
+        add(std::common_type<config::ConvoInfoVolatile>{}, "convoInfoVolatile");
+
+        actor_->tsfn = Napi::ThreadSafeFunction::New(
+                env,
+                Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+                "libsession-util ConfigActor",
+                0,
+                1);
+        actor_->tsfn.Unref(env);
+
+        // From here on, the configs must only be touched by the actor thread
+        actor_->thread = std::thread{&Actor::run, actor_.get(), actor_};
+    });
+}
+
+ConfigActorWrapper::~ConfigActorWrapper() {
+    if (!actor_ || !actor_->thread.joinable())
+        return;
+    // This runs from the garbage collector, which must not wait for the commands still queued: the
+    // thread is told to stop once they are done and left to finish on its own (it holds the actor
+    // state).  Their results are still delivered.
+    if (!actor_->closed)
+        actor_->push(new Command{});
+    actor_->thread.detach();
+}
+
+Napi::Value ConfigActorWrapper::enqueue(Napi::Env env, std::function<Result(Configs&)> run) {
+    if (actor_->closed)
+        throw std::logic_error{"ConfigActor: the actor was closed"};
+
+    auto* cmd = new Command{};
+    cmd->run = std::move(run);
+    cmd->deferred.emplace(env);
+    auto promise = cmd->deferred->Promise();
+
+    if (actor_->outstanding++ == 0)
+        actor_->tsfn.Ref(env);
+    actor_->push(cmd);
+    return promise;
+}
+
+namespace {
+
+    uint16_t to_namespace(Napi::Value val, const std::string& identifier) {
+        assertIsNumber(val);
+        return static_cast<uint16_t>(toCppInteger(val, identifier, false));
+    }
+
+    Napi::Object push_result(
+            Napi::Env env,
+            const std::tuple<config::seqno_t, ustring, std::vector<std::string>>& pushed) {
+        auto& [seqno, data, hashes] = pushed;
+        auto obj = Napi::Object::New(env);
+        obj["data"] = toJs(env, data);
+        obj["seqno"] = toJs(env, seqno);
+        obj["hashes"] = toJs(env, hashes);
+        return obj;
+    }
+
+}  // namespace
+
+Napi::Value ConfigActorWrapper::needsPush(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 1);
+        auto ns = to_namespace(info[0], "ConfigActor.needsPush");
+        return enqueue(info.Env(), [ns](Configs& configs) -> Result {
+            bool needs_push = configs.get(ns).needs_push();
+            return [needs_push](Napi::Env env) { return toJs(env, needs_push); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::needsDump(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 1);
+        auto ns = to_namespace(info[0], "ConfigActor.needsDump");
+        return enqueue(info.Env(), [ns](Configs& configs) -> Result {
+            bool needs_dump = configs.get(ns).needs_dump();
+            return [needs_dump](Napi::Env env) { return toJs(env, needs_dump); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::push(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 1);
+        auto ns = to_namespace(info[0], "ConfigActor.push");
+        return enqueue(info.Env(), [ns](Configs& configs) -> Result {
+            auto pushed = std::make_shared<
+                    std::tuple<config::seqno_t, ustring, std::vector<std::string>>>(
+                    configs.get(ns).push());
+            return [pushed](Napi::Env env) -> Napi::Value { return push_result(env, *pushed); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::pushAll(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 0);
+        return enqueue(info.Env(), [](Configs& configs) -> Result {
+            using Pushed = std::tuple<config::seqno_t, ustring, std::vector<std::string>>;
+            auto pushed = std::make_shared<std::vector<std::pair<uint16_t, Pushed>>>();
+            for (auto& conf : configs.configs)
+                if (conf->needs_push())
+                    pushed->emplace_back(
+                            static_cast<uint16_t>(conf->storage_namespace()), conf->push());
+
+            return [pushed](Napi::Env env) -> Napi::Value {
+                auto result = Napi::Array::New(env, pushed->size());
+                for (uint32_t i = 0; i < pushed->size(); i++) {
+                    auto& [ns, p] = (*pushed)[i];
+                    auto obj = push_result(env, p);
+                    obj["namespace"] = toJs(env, ns);
+                    result[i] = obj;
+                }
+                return result;
+            };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::dump(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 1);
+        auto ns = to_namespace(info[0], "ConfigActor.dump");
+        return enqueue(info.Env(), [ns](Configs& configs) -> Result {
+            auto dumped = std::make_shared<ustring>(configs.get(ns).dump());
+            return [dumped](Napi::Env env) -> Napi::Value { return toJs(env, *dumped); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::confirmPushed(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 3);
+        auto ns = to_namespace(info[0], "ConfigActor.confirmPushed");
+        assertIsNumber(info[1]);
+        assertIsString(info[2]);
+        config::seqno_t seqno = toCppInteger(info[1], "ConfigActor.confirmPushed", false);
+        auto hash = toCppString(info[2], "ConfigActor.confirmPushed");
+        return enqueue(info.Env(), [ns, seqno, hash](Configs& configs) -> Result {
+            configs.get(ns).confirm_pushed(seqno, hash);
+            return nullptr;
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::merge(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 2);
+        auto ns = to_namespace(info[0], "ConfigActor.merge");
+        assertIsArray(info[1]);
+        auto arr = info[1].As<Napi::Array>();
+
+        // Copied, as the JS buffers can't be accessed from the actor thread
+        std::vector<std::pair<std::string, ustring>> msgs;
+        msgs.reserve(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            auto item = arr.Get(i);
+            assertIsObject(item);
+            auto obj = item.As<Napi::Object>();
+            msgs.emplace_back(
+                    toCppString(obj.Get("hash"), "ConfigActor.merge"),
+                    toCppBuffer(obj.Get("data"), "ConfigActor.merge"));
+        }
+
+        return enqueue(
+                info.Env(), [ns, msgs = std::move(msgs)](Configs& configs) -> Result {
+                    std::vector<std::pair<std::string, ustring_view>> views;
+                    views.reserve(msgs.size());
+                    for (const auto& [hash, data] : msgs)
+                        views.emplace_back(hash, data);
+                    auto merged = std::make_shared<std::vector<std::string>>(
+                            configs.get(ns).merge(views));
+                    return [merged](Napi::Env env) -> Napi::Value { return toJs(env, *merged); };
+                });
+    });
+}
+
+Napi::Value ConfigActorWrapper::getUserName(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 0);
+        return enqueue(info.Env(), [](Configs& configs) -> Result {
+            // Copied, as libsession returns a view into the config
+            std::optional<std::string> name;
+            if (auto current = configs.get<config::UserProfile>().get_name())
+                name.emplace(*current);
+            return [name](Napi::Env env) -> Napi::Value { return toJs(env, name); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::setUserName(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 1);
+        assertIsStringOrNull(info[0]);
+        std::string name;
+        if (info[0].IsString())
+            name = info[0].As<Napi::String>().Utf8Value();
+        return enqueue(info.Env(), [name = std::move(name)](Configs& configs) -> Result {
+            configs.get<config::UserProfile>().set_name_truncated(name);
+            return nullptr;
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::getContact(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        auto session_id = getStringArgs<1>(info);
+        return enqueue(info.Env(), [session_id](Configs& configs) -> Result {
+            auto contact = configs.get<config::Contacts>().get(session_id);
+            return [contact](Napi::Env env) -> Napi::Value { return toJs(env, contact); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::getAllContacts(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 0);
+        return enqueue(info.Env(), [](Configs& configs) -> Result {
+            auto all = std::make_shared<std::vector<config::contact_info>>();
+            for (const auto& contact : configs.get<config::Contacts>())
+                all->push_back(contact);
+            return [all](Napi::Env env) -> Napi::Value { return toJs(env, *all); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::setContact(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 1);
+        auto set = ContactSet::fromJs(info[0], "ConfigActor.setContact");
+        return enqueue(info.Env(), [set = std::move(set)](Configs& configs) -> Result {
+            auto& contacts = configs.get<config::Contacts>();
+            auto contact = contacts.get_or_construct(set.session_id);
+            set.apply(contact);
+            contacts.set(contact);
+            return nullptr;
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::eraseContact(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        auto session_id = getStringArgs<1>(info);
+        return enqueue(info.Env(), [session_id](Configs& configs) -> Result {
+            bool erased = configs.get<config::Contacts>().erase(session_id);
+            return [erased](Napi::Env env) { return toJs(env, erased); };
+        });
+    });
+}
+
+Napi::Value ConfigActorWrapper::close(const Napi::CallbackInfo& info) {
+    return wrapExceptions(info, [&] {
+        assertInfoLength(info, 0);
+        if (actor_->closed)
+            throw std::logic_error{"ConfigActor: the actor was already closed"};
+
+        // Resolved once every command queued before it has been run
+        auto env = info.Env();
+        auto* cmd = new Command{};
+        cmd->deferred.emplace(env);
+        auto promise = cmd->deferred->Promise();
+        if (actor_->outstanding++ == 0)
+            actor_->tsfn.Ref(env);
+        actor_->closed = true;
+        actor_->push(cmd);
+        return promise;
+    });
+}
+
+}  // namespace session::nodeapi
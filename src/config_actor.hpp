@@ -0,0 +1,61 @@
+#pragma once
+
+#include <napi.h>
+
+#include <functional>
+#include <memory>
+
+namespace session::nodeapi {
+
+/// Owns the user configs of an account (UserProfile, Contacts, UserGroups and ConvoInfoVolatile)
+/// on a dedicated native thread, so that none of the libsession work happens on the JS thread.
+///
+/// Every method enqueues a command and returns a Promise of its result.  Commands run one after
+/// the other, in the order they were made, and the ones queued by the time the thread wakes up are
+/// run (and their results handed back to JS) as one batch.  Configs are addressed by their storage
+/// namespace.
+///
+/// The configs owned by an actor are not reachable through the config wrappers.  The user name and
+/// the contacts can be read and edited through the actor; for anything else, `dump` the config to
+/// hand it over to a wrapper.
+///
+/// `close` stops the thread once the commands queued before it ran.  An actor which is garbage
+/// collected without being closed does the same, without waiting for its thread.
+class ConfigActorWrapper : public Napi::ObjectWrap<ConfigActorWrapper> {
+  public:
+    static void Init(Napi::Env env, Napi::Object exports);
+
+    ConfigActorWrapper(const Napi::CallbackInfo& info);
+    ~ConfigActorWrapper();
+
+    struct Actor;
+    struct Configs;
+
+    // What a command returns, once back on the JS thread
+    using Result = std::function<Napi::Value(Napi::Env)>;
+
+  private:
+    std::shared_ptr<Actor> actor_;
+
+    // Queues `run` for the actor thread, returning the promise of its result.
+    Napi::Value enqueue(Napi::Env env, std::function<Result(Configs&)> run);
+
+    Napi::Value needsPush(const Napi::CallbackInfo& info);
+    Napi::Value needsDump(const Napi::CallbackInfo& info);
+    Napi::Value push(const Napi::CallbackInfo& info);
+    Napi::Value pushAll(const Napi::CallbackInfo& info);
+    Napi::Value dump(const Napi::CallbackInfo& info);
+    Napi::Value confirmPushed(const Napi::CallbackInfo& info);
+    Napi::Value merge(const Napi::CallbackInfo& info);
+
+    Napi::Value getUserName(const Napi::CallbackInfo& info);
+    Napi::Value setUserName(const Napi::CallbackInfo& info);
+    Napi::Value getContact(const Napi::CallbackInfo& info);
+    Napi::Value getAllContacts(const Napi::CallbackInfo& info);
+    Napi::Value setContact(const Napi::CallbackInfo& info);
+    Napi::Value eraseContact(const Napi::CallbackInfo& info);
+
+    Napi::Value close(const Napi::CallbackInfo& info);
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,257 @@
+#include "config_batch.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "base_config.hpp"
+#include "contacts_config.hpp"
+#include "convo_info_volatile_config.hpp"
+#include "meta/meta_base_wrapper.hpp"
+#include "meta_group_wrapper.hpp"
+#include "parallel.hpp"
+#include "user_config.hpp"
+#include "user_groups_config.hpp"
+
+namespace session::nodeapi {
+
+namespace {
+
+    // Unwraps any of the config wrappers, throwing if `val` is not one of them.  Returns its
+    // configs: one, or the Info and Members of a group wrapper.
+    std::vector<ConfigBaseImpl*> unwrap_any(Napi::Value val, const std::string& identifier) {
+        if (auto* impl = ConfigBaseImpl::maybeUnwrapImpl<UserConfigWrapper>(val))
+            return {impl};
+        if (auto* impl = ConfigBaseImpl::maybeUnwrapImpl<ContactsConfigWrapper>(val))
+            return {impl};
+        if (auto* impl = ConfigBaseImpl::maybeUnwrapImpl<UserGroupsWrapper>(val))
+            return {impl};
+        if (auto* impl = ConfigBaseImpl::maybeUnwrapImpl<ConvoInfoVolatileWrapper>(val))
+            return {impl};
+        if (auto* group = MetaGroupWrapper::maybeUnwrap(val))
+            return group->configs();
+        throw std::invalid_argument{identifier + ": expected a config wrapper"};
+    }
+
+}  // namespace
+
+void ConfigBatchWrapper::Init(Napi::Env env, Napi::Object exports) {
+    MetaBaseWrapper::NoBaseClassInitHelper<ConfigBatchWrapper>(
+            env,
+            exports,
+            "ConfigBatchWrapperNode",
+            {
+                    StaticMethod<&ConfigBatchWrapper::pushAll>(
+                            "pushAll",
+                            static_cast<napi_property_attributes>(
+                                    napi_writable | napi_configurable)),
+                    StaticMethod<&ConfigBatchWrapper::confirmPushedAll>(
+                            "confirmPushedAll",
+                            static_cast<napi_property_attributes>(
+                                    napi_writable | napi_configurable)),
+                    StaticMethod<&ConfigBatchWrapper::transaction>(
+                            "transaction",
+                            static_cast<napi_property_attributes>(
+                                    napi_writable | napi_configurable)),
+                    StaticMethod<&ConfigBatchWrapper::memoryUsageAll>(
+                            "memoryUsageAll",
+                            static_cast<napi_property_attributes>(
+                                    napi_writable | napi_configurable)),
+            });
+}
+
+Napi::Value ConfigBatchWrapper::pushAll(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&] {
+        assertInfoLength(info, 1);
+        assertIsArray(info[0]);
+        auto wrappers = info[0].As<Napi::Array>();
+
+        std::vector<ConfigBaseImpl*> dirty;
+        for (uint32_t i = 0; i < wrappers.Length(); i++) {
+            for (auto* impl : unwrap_any(wrappers.Get(i), "pushAll")) {
+                // The same wrapper given twice must not be pushed concurrently with itself
+                if (impl->needsPushConfig() &&
+                    std::find(dirty.begin(), dirty.end(), impl) == dirty.end())
+                    dirty.push_back(impl);
+            }
+        }
+
+        std::vector<std::tuple<config::seqno_t, ustring, std::vector<std::string>>> pushed(
+                dirty.size());
+        try {
+            parallel_for(dirty.size(), [&](size_t i) { pushed[i] = dirty[i]->pushConfig(); });
+        } catch (...) {
+            for (auto* impl : dirty) {
+                impl->flushPendingLogs();
+                impl->updateStatus();
+            }
+            throw;
+        }
+        // The logs and status blocks are JS values, so they are only updated once the pool is done
+        for (auto* impl : dirty) {
+            impl->flushPendingLogs();
+            impl->updateStatus();
+        }
+
+        auto result = Napi::Array::New(env, dirty.size());
+        for (size_t i = 0; i < dirty.size(); i++) {
+            auto& [seqno, data, hashes] = pushed[i];
+            auto obj = Napi::Object::New(env);
+            obj["namespace"] = toJs(env, dirty[i]->storageNamespaceConfig());
+            obj["seqno"] = toJs(env, seqno);
+            obj["data"] = toJs(env, data);
+            obj["hashes"] = toJs(env, hashes);
+            result[i] = obj;
+        }
+        return result;
+    });
+}
+
+void ConfigBatchWrapper::confirmPushedAll(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        assertIsArray(info[0]);
+        auto confirmations = info[0].As<Napi::Array>();
+
+        // Validate everything first, so that an invalid entry doesn't leave the batch half-applied
+        std::vector<std::tuple<ConfigBaseImpl*, config::seqno_t, std::string>> todo;
+        todo.reserve(confirmations.Length());
+        for (uint32_t i = 0; i < confirmations.Length(); i++) {
+            auto val = confirmations.Get(i);
+            assertIsObject(val);
+            auto obj = val.As<Napi::Object>();
+            assertIsNumber(obj.Get("seqno"));
+            assertIsString(obj.Get("hash"));
+
+            // A group wrapper pushes several configs: its entries tell which one by namespace
+            auto impls = unwrap_any(obj.Get("wrapper"), "confirmPushedAll");
+            auto* impl = impls.front();
+            if (impls.size() > 1) {
+                auto ns = toCppInteger(obj.Get("namespace"), "confirmPushedAll.namespace", false);
+                auto it = std::find_if(impls.begin(), impls.end(), [ns](auto* i) {
+                    return i->storageNamespaceConfig() == ns;
+                });
+                if (it == impls.end())
+                    throw std::invalid_argument{
+                            "confirmPushedAll: the group has no config in namespace " +
+                            std::to_string(ns)};
+                impl = *it;
+            }
+            todo.emplace_back(
+                    impl,
+                    toCppInteger(obj.Get("seqno"), "confirmPushedAll", false),
+                    toCppString(obj.Get("hash"), "confirmPushedAll"));
+        }
+
+        for (const auto& [impl, seqno, hash] : todo)
+            impl->confirmPushedConfig(seqno, hash);
+    });
+}
+
+Napi::Value ConfigBatchWrapper::transaction(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    std::vector<ConfigBaseImpl*> impls;
+    wrapExceptions(env, [&] {
+        assertInfoLength(info, 2);
+        assertIsArray(info[0]);
+        if (!info[1].IsFunction())
+            throw std::invalid_argument{"transaction: expected a function"};
+
+        auto wrappers = info[0].As<Napi::Array>();
+        for (uint32_t i = 0; i < wrappers.Length(); i++) {
+            for (auto* impl : unwrap_any(wrappers.Get(i), "transaction"))
+                if (std::find(impls.begin(), impls.end(), impl) == impls.end())
+                    impls.push_back(impl);
+        }
+    });
+
+    auto rollback_all = [&](size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            try {
+                impls[i]->rollbackTransaction();
+            } catch (const std::exception&) {
+                // Keep rolling back the others: the original error is the one to report
+            }
+        }
+    };
+
+    size_t begun = 0;
+    try {
+        for (; begun < impls.size(); begun++)
+            impls[begun]->beginTransaction();
+    } catch (const std::exception& e) {
+        rollback_all(begun);
+        throw Napi::Error::New(env, e.what());
+    }
+
+    Napi::Value result;
+    try {
+        result = info[1].As<Napi::Function>().Call({});
+    } catch (const Napi::Error&) {
+        rollback_all(impls.size());
+        throw;  // rethrown as is, so that JS gets back its own error
+    }
+
+    // An async function returns before its changes are done: committing there would commit
+    // whatever it did up to its first await
+    if (result.IsObject() && result.As<Napi::Object>().Get("then").IsFunction()) {
+        rollback_all(impls.size());
+        throw Napi::TypeError::New(
+                env, "transaction: the function must be synchronous, but it returned a promise");
+    }
+
+    // Every wrapper is committed even if one of them fails, so that none is left in a transaction;
+    // the first failure is then reported (as a JS error: nothing above this converts exceptions)
+    std::optional<std::string> error;
+    for (auto* impl : impls) {
+        try {
+            impl->commitTransaction();
+        } catch (const std::exception& e) {
+            if (!error)
+                error = e.what();
+        }
+    }
+    if (error)
+        throw Napi::Error::New(env, *error);
+    return result;
+}
+
+Napi::Value ConfigBatchWrapper::memoryUsageAll(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&] {
+        assertInfoLength(info, 0);
+
+        // Collections of the same name (e.g. the communities of UserGroups and ConvoInfoVolatile)
+        // are added up
+        ConfigBaseImpl::MemoryUsage sum;
+        for (auto* impl : ConfigBaseImpl::liveWrappers()) {
+            auto usage = impl->memoryUsageConfig();
+            for (auto& c : usage.collections) {
+                auto it = std::find_if(
+                        sum.collections.begin(), sum.collections.end(), [&](const auto& s) {
+                            return s.name == c.name;
+                        });
+                if (it == sum.collections.end()) {
+                    sum.collections.push_back(std::move(c));
+                } else {
+                    it->entries += c.entries;
+                    it->bytes += c.bytes;
+                }
+            }
+            sum.push_cache += usage.push_cache;
+            sum.seen_hashes += usage.seen_hashes;
+            sum.transactions += usage.transactions;
+            sum.snapshot += usage.snapshot;
+            sum.ingest_buffer += usage.ingest_buffer;
+        }
+
+        auto result = toJs(env, sum);
+        result["wrappers"] = toJs(env, ConfigBaseImpl::liveWrappers().size());
+        return result;
+    });
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <napi.h>
+
+namespace session::nodeapi {
+
+/// All-static wrapper for the operations spanning several config wrappers (of any type): the push
+/// cycle (one call to find and push the dirty ones, encrypted in parallel, and one call to confirm
+/// them), transactions and memory usage totals.
+class ConfigBatchWrapper : public Napi::ObjectWrap<ConfigBatchWrapper> {
+  public:
+    ConfigBatchWrapper(const Napi::CallbackInfo& info) :
+            Napi::ObjectWrap<ConfigBatchWrapper>{info} {
+        throw std::invalid_argument(
+                "ConfigBatchWrapper is all static and don't need to be constructed");
+    }
+
+    static void Init(Napi::Env env, Napi::Object exports);
+
+  private:
+    static Napi::Value pushAll(const Napi::CallbackInfo& info);
+    static void confirmPushedAll(const Napi::CallbackInfo& info);
+    static Napi::Value transaction(const Napi::CallbackInfo& info);
+    static Napi::Value memoryUsageAll(const Napi::CallbackInfo& info);
+};
+
+}  // namespace session::nodeapi
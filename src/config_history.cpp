@@ -0,0 +1,53 @@
+#include "config_history.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "base_config.hpp"
+
+namespace session::nodeapi {
+
+ConfigHistory::Point ConfigHistory::end(const char* identifier) {
+    if (transactions_.empty())
+        throw std::logic_error{std::string{identifier} + ": no transaction in progress"};
+    auto point = std::move(transactions_.back());
+    transactions_.pop_back();
+    return point;
+}
+
+Napi::Value ConfigHistory::snapshot(
+        Napi::Env env, Point current, const std::function<ustring()>& dump) {
+    if (!last_snapshot_ || last_snapshot_->mutation_count != current.mutation_count) {
+        current.dump = std::make_shared<const ustring>(dump());
+        last_snapshot_ = std::move(current);
+    }
+
+    auto ext = Napi::External<Point>::New(
+            env, new Point{*last_snapshot_}, [](Napi::Env, Point* p) { delete p; });
+    // (node-addon-api only offers type tags on Objects, but napi supports them on Externals)
+    if (napi_type_tag_object(env, ext, wrapper_type_tag<Point>()) != napi_ok)
+        throw std::runtime_error{"snapshot: failed to tag the snapshot"};
+    return ext;
+}
+
+const ConfigHistory::Point& ConfigHistory::unwrapSnapshot(
+        Napi::Env env, Napi::Value val, uint64_t owner) {
+    bool is_snapshot = false;
+    if (val.IsExternal())
+        napi_check_object_type_tag(env, val, wrapper_type_tag<Point>(), &is_snapshot);
+    if (!is_snapshot)
+        throw std::invalid_argument{"restore: expected a snapshot"};
+    const auto& point = *val.As<Napi::External<Point>>().Data();
+    if (point.owner != owner)
+        throw std::invalid_argument{"restore: snapshot taken from another wrapper"};
+    return point;
+}
+
+size_t ConfigHistory::transactionBytes() const {
+    size_t bytes = 0;
+    for (const auto& tx : transactions_)
+        bytes += tx.dump->size();
+    return bytes;
+}
+
+}  // namespace session::nodeapi
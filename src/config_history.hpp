@@ -0,0 +1,64 @@
+#pragma once
+
+#include <napi.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "session/types.hpp"
+
+namespace session::nodeapi {
+
+/// The earlier states a config can be reverted to: the rollback points of the transactions in
+/// progress (innermost last), and the last snapshot handed out to JS by `snapshot()`.
+class ConfigHistory {
+  public:
+    struct Point {
+        uint64_t owner;  // the instance id of the wrapper it was taken from
+        uint32_t mutation_count;
+        uint32_t remote_changes;  // the wrapper's count of merges and confirmPushed at the time
+        int64_t last_seqno;       // the wrapper's last pushed or confirmed seqno at the time
+        std::shared_ptr<const ustring> dump;
+    };
+
+    // Starts a (possibly nested) transaction, which can be reverted to `point`.
+    void begin(Point point) { transactions_.push_back(std::move(point)); }
+
+    // Ends the innermost transaction, returning its rollback point.  Throws std::logic_error if
+    // there is no transaction in progress.
+    Point end(const char* identifier);
+
+    bool inTransaction() const { return !transactions_.empty(); }
+
+    // The changes made during a transaction are only reported once the outermost one ends:
+    // `defer` records them, and `takeDeferred` returns (and forgets) them.
+    void defer(uint8_t kinds) { deferred_ |= kinds; }
+    uint8_t takeDeferred() { return std::exchange(deferred_, 0); }
+
+    // Returns a snapshot of the config (whose current state is `current`, without its dump) as a
+    // JS External, which `unwrapSnapshot` gives back.  The last snapshot is kept, so that snapshots
+    // taken while the config is unchanged share the same dump; `dump` is only called otherwise.
+    Napi::Value snapshot(Napi::Env env, Point current, const std::function<ustring()>& dump);
+
+    // Returns the point held by a snapshot from JS.  Throws std::invalid_argument if `val` is not a
+    // snapshot taken from the wrapper `owner`.
+    static const Point& unwrapSnapshot(Napi::Env env, Napi::Value val, uint64_t owner);
+
+    // Sets the point the next snapshot can reuse (when the config is back to a snapshot's state).
+    void setLastSnapshot(Point point) { last_snapshot_ = std::move(point); }
+    void dropLastSnapshot() { last_snapshot_.reset(); }
+
+    size_t transactionBytes() const;
+    size_t snapshotBytes() const { return last_snapshot_ ? last_snapshot_->dump->size() : 0; }
+
+  private:
+    std::vector<Point> transactions_;
+    uint8_t deferred_ = 0;
+    std::optional<Point> last_snapshot_;
+};
+
+}  // namespace session::nodeapi
@@ -1,5 +1,6 @@
 #include "constants.hpp"
 
+#include "base_config.hpp"
 #include "session/config/contacts.hpp"
 #include "session/config/groups/info.hpp"
 #include "session/config/user_groups.hpp"
@@ -30,6 +31,10 @@ Napi::Object ConstantsWrapper::Init(Napi::Env env, Napi::Object exports) {
              ObjectWrap::StaticValue(
                      "COMMUNITY_FULL_URL_MAX_LENGTH",
                      Napi::Number::New(env, session::config::community::FULL_URL_MAX_LENGTH),
+                     napi_enumerable),
+             ObjectWrap::StaticValue(
+                     "CONFIG_MAX_PUSH_SIZE",
+                     Napi::Number::New(env, ConfigBaseImpl::MAX_PUSH_SIZE),
                      napi_enumerable)});
 
     // export object as javascript module
@@ -3,6 +3,7 @@
 #include <optional>
 
 #include "profile_pic.hpp"
+#include "query.hpp"
 #include "session/config/expiring.hpp"
 #include "session/types.hpp"
 
@@ -34,27 +35,87 @@ inline constexpr expiration_mode expiration_mode_from_string(std::string_view mo
     return expiration_mode::none;
 }
 
-template <>
-struct toJs_impl<contact_info> {
-    Napi::Object operator()(const Napi::Env& env, const contact_info& contact) {
-        auto obj = Napi::Object::New(env);
-
-        obj["id"] = toJs(env, contact.session_id);
-        obj["name"] = toJs(env, maybe_string(contact.name));
-        obj["nickname"] = toJs(env, maybe_string(contact.nickname));
-        obj["approved"] = toJs(env, contact.approved);
-        obj["approvedMe"] = toJs(env, contact.approved_me);
-        obj["blocked"] = toJs(env, contact.blocked);
-        obj["priority"] = toJs(env, contact.priority);
-        obj["createdAtSeconds"] = toJs(env, contact.created);
-        obj["expirationMode"] = toJs(env, expiration_mode_string(contact.exp_mode));
-        obj["expirationTimerSeconds"] = toJs(env, contact.exp_timer.count());
-        obj["profilePicture"] = object_from_profile_pic(env, contact.profile_picture);
-
-        return obj;
-    }
+static const QueryFields<contact_info> contact_fields{
+        {"id", [](const contact_info& c) -> FieldValue { return c.session_id; }},
+        {"name", [](const contact_info& c) { return maybe_field(c.name); }},
+        {"nickname", [](const contact_info& c) { return maybe_field(c.nickname); }},
+        {"approved", [](const contact_info& c) -> FieldValue { return c.approved; }},
+        {"approvedMe", [](const contact_info& c) -> FieldValue { return c.approved_me; }},
+        {"blocked", [](const contact_info& c) -> FieldValue { return c.blocked; }},
+        {"priority", [](const contact_info& c) -> FieldValue { return int64_t{c.priority}; }},
+        {"createdAtSeconds", [](const contact_info& c) -> FieldValue { return c.created; }},
+        {"expirationMode",
+         [](const contact_info& c) -> FieldValue {
+             return std::string{expiration_mode_string(c.exp_mode)};
+         }},
+        {"expirationTimerSeconds",
+         [](const contact_info& c) -> FieldValue { return int64_t{c.exp_timer.count()}; }},
+        {"profilePicture",
+         nullptr,
+         [](const Napi::Env& env, const contact_info& c) -> Napi::Value {
+             return object_from_profile_pic(env, c.profile_picture);
+         }},
 };
 
+Napi::Object toJs_impl<contact_info>::operator()(
+        const Napi::Env& env, const contact_info& contact) {
+    return object_from_fields(env, contact_fields, contact);
+}
+
+ContactSet ContactSet::fromJs(Napi::Value arg, const std::string& identifier) {
+    assertIsObject(arg);
+    auto obj = arg.As<Napi::Object>();
+
+    if (obj.IsEmpty())
+        throw std::invalid_argument("cppContact received empty");
+
+    ContactSet set;
+    set.session_id = toCppString(obj.Get("id"), identifier + ", id");
+    set.created =
+            toCppInteger(obj.Get("createdAtSeconds"), identifier + ", createdAtSeconds", false);
+    set.name = maybeNonemptyString(obj.Get("name"), identifier + " name");
+    set.nickname = maybeNonemptyString(obj.Get("nickname"), identifier + " nickname");
+    set.approved = toCppBoolean(obj.Get("approved"), identifier + " approved");
+    set.approved_me = toCppBoolean(obj.Get("approvedMe"), identifier + " approvedMe");
+    set.blocked = toCppBoolean(obj.Get("blocked"), identifier + " blocked");
+    set.priority = toCppInteger(obj.Get("priority"), "toPriority", true);
+    set.exp_mode = expiration_mode_from_string(
+            toCppString(obj.Get("expirationMode"), identifier + " expirationMode"));
+    set.exp_timer = std::chrono::seconds{toCppInteger(
+            obj.Get("expirationTimerSeconds"), identifier + " expirationTimerSeconds")};
+    if (auto pic = obj.Get("profilePicture"); !pic.IsUndefined())
+        set.profile_picture = profile_pic_from_object(pic);
+    return set;
+}
+
+void ContactSet::apply(contact_info& contact) const {
+    // we don't allow overiding the `created` field once it is set.
+    if (contact.created == 0)
+        if (created > 0)  // if we were given something valid, use it
+            contact.created = created;
+        else  // otherwise, init as now() (the field is already equal to 0 here, so we need a
+              // created time)
+            contact.created = unix_timestamp_now();
+
+    if (name)
+        contact.set_name(*name);
+    // if no nickname are passed from the JS side, reset the nickname
+    contact.set_nickname(nickname.value_or(""));
+
+    contact.approved = approved;
+    contact.approved_me = approved_me;
+    contact.blocked = blocked;
+    contact.priority = toPriority(priority, contact.priority);
+
+    contact.exp_mode = exp_mode;
+    contact.exp_timer = exp_timer;
+    // if no profile picture are given from the JS side, reset that user profile picture
+    if (profile_picture)
+        contact.profile_picture = *profile_picture;
+    else
+        contact.profile_picture.clear();
+}
+
 void ContactsConfigWrapper::Init(Napi::Env env, Napi::Object exports) {
     InitHelper<ContactsConfigWrapper>(
             env,
@@ -63,14 +124,19 @@ void ContactsConfigWrapper::Init(Napi::Env env, Napi::Object exports) {
             {
                     InstanceMethod("get", &ContactsConfigWrapper::get),
                     InstanceMethod("getAll", &ContactsConfigWrapper::getAll),
+                    InstanceMethod("search", &ContactsConfigWrapper::search),
+                    InstanceMethod("query", &ContactsConfigWrapper::query),
                     InstanceMethod("set", &ContactsConfigWrapper::set),
                     InstanceMethod("erase", &ContactsConfigWrapper::erase),
+                    InstanceMethod("exportReadOnly", &ContactsConfigWrapper::exportReadOnly),
             });
 }
 
 ContactsConfigWrapper::ContactsConfigWrapper(const Napi::CallbackInfo& info) :
         ConfigBaseImpl{construct<Contacts>(info, "ContactsConfig")},
-        Napi::ObjectWrap<ContactsConfigWrapper>{info} {}
+        Napi::ObjectWrap<ContactsConfigWrapper>{info} {
+    tagInstance<ContactsConfigWrapper>(info);
+}
 
 /** ==============================
  *             GETTERS
@@ -78,7 +144,7 @@ ContactsConfigWrapper::ContactsConfigWrapper(const Napi::CallbackInfo& info) :
 
 Napi::Value ContactsConfigWrapper::get(const Napi::CallbackInfo& info) {
     auto env = info.Env();
-    return wrapResult(env, [&] { return config.get(getStringArgs<1>(info)); });
+    return wrapResult(env, [&] { return config().get(getStringArgs<1>(info)); });
 }
 
 Napi::Value ContactsConfigWrapper::getAll(const Napi::CallbackInfo& info) {
@@ -86,14 +152,54 @@ Napi::Value ContactsConfigWrapper::getAll(const Napi::CallbackInfo& info) {
     return wrapExceptions(env, [&] {
         assertInfoLength(info, 0);
 
-        auto contacts = Napi::Array::New(env, config.size());
+        auto contacts = Napi::Array::New(env, config().size());
         size_t i = 0;
-        for (const auto& contact : config)
+        for (const auto& contact : config())
             contacts[i++] = toJs(env, contact);
         return contacts;
     });
 }
 
+Napi::Value ContactsConfigWrapper::query(const Napi::CallbackInfo& info) {
+    return query_impl(info, contact_fields, config().begin(), config().end(), "contacts.query");
+}
+
+Napi::Value ContactsConfigWrapper::search(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapExceptions(env, [&] {
+        assertInfoLength(info, 2);
+        assertIsString(info[0]);
+        assertIsNumber(info[1]);
+
+        auto query = toCppString(info[0], "contacts.search query");
+        auto limit = toCppInteger(info[1], "contacts.search limit");
+        if (limit < 0)
+            throw std::invalid_argument{"contacts.search limit must be >= 0"};
+
+        if (search_index_stale_) {
+            search_index_.clear();
+            for (const auto& contact : config())
+                search_index_.set(contact.session_id, contact.name, contact.nickname);
+            search_index_stale_ = false;
+        }
+
+        auto ids = search_index_.search(query, static_cast<size_t>(limit));
+
+        // An id of the index without a contact is left out, so the array is sized by the contacts
+        // actually found (rather than having holes).
+        std::vector<contact_info> found;
+        found.reserve(ids.size());
+        for (const auto& id : ids)
+            if (auto contact = config().get(id))
+                found.push_back(std::move(*contact));
+
+        auto contacts = Napi::Array::New(env, found.size());
+        for (size_t i = 0; i < found.size(); i++)
+            contacts[i] = toJs(env, found[i]);
+        return contacts;
+    });
+}
+
 /** ==============================
  *             SETTERS
  * ============================== */
@@ -102,51 +208,14 @@ void ContactsConfigWrapper::set(const Napi::CallbackInfo& info) {
     wrapExceptions(info, [&] {
         assertInfoLength(info, 1);
 
-        auto arg = info[0];
-        assertIsObject(arg);
-        auto obj = arg.As<Napi::Object>();
-
-        if (obj.IsEmpty())
-            throw std::invalid_argument("cppContact received empty");
-
-        auto contact = config.get_or_construct(toCppString(obj.Get("id"), "contacts.set, id"));
-
-        auto createdFromJS =
-                toCppInteger(obj.Get("createdAtSeconds"), "contacts.set, createdAtSeconds", false);
-
-        // we don't allow overiding the `created` field once it is set.
-        if (contact.created == 0)
-            if (createdFromJS > 0)  // if we were given something valid, use it
-                contact.created = createdFromJS;
-            else  // otherwise, init as now() (the field is already equal to 0 here, so we need a
-                  // created time)
-                contact.created = unix_timestamp_now();
-
-        if (auto name = maybeNonemptyString(obj.Get("name"), "contacts.set name"))
-            contact.set_name(std::move(*name));
-        if (auto nickname = maybeNonemptyString(obj.Get("nickname"), "contacts.set nickname"))
-            contact.set_nickname(std::move(*nickname));
-        else
-            contact.set_nickname("");
-        // if no nickname are passed from the JS side, reset the nickname
-
-        contact.approved = toCppBoolean(obj.Get("approved"), "contacts.set approved");
-        contact.approved_me = toCppBoolean(obj.Get("approvedMe"), "contacts.set approvedMe");
-        contact.blocked = toCppBoolean(obj.Get("blocked"), "contacts.set blocked");
-        contact.priority = toPriority(obj.Get("priority"), contact.priority);
-
-        contact.exp_mode = expiration_mode_from_string(
-                toCppString(obj.Get("expirationMode"), "contacts.set expirationMode"));
-        contact.exp_timer = std::chrono::seconds{toCppInteger(
-                obj.Get("expirationTimerSeconds"), "contacts.set expirationTimerSeconds")};
-        if (auto pic = obj.Get("profilePicture"); !pic.IsUndefined())
-            contact.profile_picture = profile_pic_from_object(pic);
-        else
-            contact.profile_picture.clear();
-        // if no profile picture are given from the JS side,
-        // reset that user profile picture
-
-        config.set(contact);
+        auto set = ContactSet::fromJs(info[0], "contacts.set");
+        auto contact = config().get_or_construct(set.session_id);
+        set.apply(contact);
+
+        Mutation mutation{*this};
+        config().set(contact);
+        if (!search_index_stale_)
+            search_index_.set(contact.session_id, contact.name, contact.nickname);
     });
 }
 
@@ -155,7 +224,74 @@ void ContactsConfigWrapper::set(const Napi::CallbackInfo& info) {
  * ============================== */
 
 Napi::Value ContactsConfigWrapper::erase(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.erase(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] {
+        auto session_id = getStringArgs<1>(info);
+        search_index_.erase(session_id);
+        Mutation mutation{*this};
+        auto erased = config().erase(session_id);
+        return erased;
+    });
+}
+
+auto ContactsConfigWrapper::collectionUsage() -> std::vector<CollectionUsage> {
+    CollectionUsage contacts{"contacts"};
+    for (const auto& c : config()) {
+        contacts.entries++;
+        contacts.bytes += sizeof(c) + c.session_id.size() + c.name.size() + c.nickname.size() +
+                          c.profile_picture.url.size() + c.profile_picture.key.size();
+    }
+    return {contacts};
+}
+
+/** ==============================
+ *            READ-ONLY
+ * ============================== */
+
+struct ContactsReadOnlyData : ReadOnlyRegistry::Data {
+    std::vector<contact_info> contacts;  // sorted by session id
+};
+
+static const std::string& contact_id(const contact_info& c) {
+    return c.session_id;
+}
+
+Napi::Value ContactsConfigWrapper::exportReadOnly(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        auto data = std::make_shared<ContactsReadOnlyData>();
+        data->contacts = copy_sorted<contact_info>(
+                config().begin(), config().end(), contact_id);
+        return ContactsReadOnlyWrapper::create(info.Env(), data);
+    });
+}
+
+void ContactsReadOnlyWrapper::Init(Napi::Env env, Napi::Object exports) {
+    InitClass(
+            env,
+            exports,
+            "ContactsReadOnlyNode",
+            {
+                    InstanceMethod("get", &ContactsReadOnlyWrapper::get),
+                    InstanceMethod("getAll", &ContactsReadOnlyWrapper::getAll),
+            });
+}
+
+Napi::Value ContactsReadOnlyWrapper::get(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        return find_sorted(data_->contacts, contact_id, getStringArgs<1>(info));
+    });
+}
+
+Napi::Value ContactsReadOnlyWrapper::getAll(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapExceptions(env, [&] {
+        assertInfoLength(info, 0);
+        const auto& contacts = data_->contacts;
+        auto result = Napi::Array::New(env, contacts.size());
+        for (size_t i = 0; i < contacts.size(); i++)
+            result[i] = toJs(env, contacts[i]);
+        return result;
+    });
 }
 
 }  // namespace session::nodeapi
@@ -2,11 +2,39 @@
 
 #include <napi.h>
 
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
 #include "base_config.hpp"
+#include "readonly_registry.hpp"
+#include "search_index.hpp"
 #include "session/config/contacts.hpp"
 
 namespace session::nodeapi {
 
+/// The argument of `contacts.set`, read on the JS thread, then applied to the contact found in (or
+/// constructed by) the config wherever the config lives (see ConfigActorWrapper).
+struct ContactSet {
+    std::string session_id;
+    int64_t created;
+    std::optional<std::string> name;
+    std::optional<std::string> nickname;
+    bool approved;
+    bool approved_me;
+    bool blocked;
+    int64_t priority;
+    config::expiration_mode exp_mode;
+    std::chrono::seconds exp_timer;
+    std::optional<config::profile_pic> profile_picture;
+
+    // Throws if `arg` isn't a valid contact object.
+    static ContactSet fromJs(Napi::Value arg, const std::string& identifier);
+
+    void apply(config::contact_info& contact) const;
+};
+
 class ContactsConfigWrapper : public ConfigBaseImpl,
                               public Napi::ObjectWrap<ContactsConfigWrapper> {
   public:
@@ -15,12 +43,45 @@ class ContactsConfigWrapper : public ConfigBaseImpl,
     explicit ContactsConfigWrapper(const Napi::CallbackInfo& info);
 
   private:
-    config::Contacts& config{get_config<config::Contacts>()};
+    config::Contacts& config() { return get_config<config::Contacts>(); }
+
+    // Name/nickname index used by `search`.  Built on the first search, then kept up to date by
+    // `set` and `erase`; a merge or rollback can change any contact so it marks the index for a
+    // rebuild.
+    NameSearchIndex search_index_;
+    bool search_index_stale_ = true;
+
+    void onExternalChange() override { search_index_stale_ = true; }
+    std::vector<CollectionUsage> collectionUsage() override;
 
     Napi::Value get(const Napi::CallbackInfo& info);
     Napi::Value getAll(const Napi::CallbackInfo& info);
+    Napi::Value query(const Napi::CallbackInfo& info);
+    Napi::Value search(const Napi::CallbackInfo& info);
     void set(const Napi::CallbackInfo& info);
     Napi::Value erase(const Napi::CallbackInfo& info);
+    Napi::Value exportReadOnly(const Napi::CallbackInfo& info);
+};
+
+struct ContactsReadOnlyData;
+
+/// Immutable copy of the contacts, returned by `ContactsConfigWrapper.exportReadOnly()` and opened
+/// from any thread by its handle (see ReadOnlyWrapper).
+class ContactsReadOnlyWrapper
+        : public ReadOnlyWrapper<ContactsReadOnlyWrapper, ContactsReadOnlyData> {
+  public:
+    static void Init(Napi::Env env, Napi::Object exports);
+
+    using ReadOnlyWrapper::ReadOnlyWrapper;
+
+  private:
+    Napi::Value get(const Napi::CallbackInfo& info);
+    Napi::Value getAll(const Napi::CallbackInfo& info);
+};
+
+template <>
+struct toJs_impl<config::contact_info> {
+    Napi::Object operator()(const Napi::Env& env, const config::contact_info& contact);
 };
 
 }  // namespace session::nodeapi
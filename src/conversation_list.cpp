@@ -0,0 +1,216 @@
+#include "conversation_list.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+
+#include "base_config.hpp"
+#include "contacts_config.hpp"
+#include "convo_info_volatile_config.hpp"
+#include "meta/meta_base_wrapper.hpp"
+#include "user_groups_config.hpp"
+
+namespace session::nodeapi {
+
+using namespace std::literals;
+
+namespace {
+
+    struct Conversation {
+        std::string_view type;
+        std::string id;
+        std::optional<std::string> name;
+        int priority = 0;
+        bool unread = false;
+        int64_t last_read = 0;
+    };
+
+}  // namespace
+
+template <>
+struct toJs_impl<Conversation> {
+    Napi::Object operator()(const Napi::Env& env, const Conversation& convo) {
+        auto obj = Napi::Object::New(env);
+
+        obj["type"] = toJs(env, convo.type);
+        obj["id"] = toJs(env, convo.id);
+        obj["name"] = toJs(env, convo.name);
+        obj["priority"] = toJs(env, convo.priority);
+        obj["unread"] = toJs(env, convo.unread);
+        obj["lastRead"] = toJs(env, convo.last_read);
+
+        return obj;
+    }
+};
+
+void ConversationListWrapper::Init(Napi::Env env, Napi::Object exports) {
+    MetaBaseWrapper::NoBaseClassInitHelper<ConversationListWrapper>(
+            env,
+            exports,
+            "ConversationListWrapperNode",
+            {
+                    StaticMethod<&ConversationListWrapper::conversationList>(
+                            "conversationList",
+                            static_cast<napi_property_attributes>(
+                                    napi_writable | napi_configurable)),
+            });
+}
+
+Napi::Value ConversationListWrapper::conversationList(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapExceptions(env, [&] {
+        assertInfoLength(info, 4);
+        auto& user_groups = ConfigBaseImpl::unwrapConfig<UserGroupsWrapper, config::UserGroups>(
+                info[0], "conversationList userGroups");
+        auto& contacts = ConfigBaseImpl::unwrapConfig<ContactsConfigWrapper, config::Contacts>(
+                info[1], "conversationList contacts");
+        auto& convo_info =
+                ConfigBaseImpl::unwrapConfig<ConvoInfoVolatileWrapper, config::ConvoInfoVolatile>(
+                        info[2], "conversationList convoInfo");
+
+        assertIsObject(info[3]);
+        auto opts = info[3].As<Napi::Object>();
+        auto sort = maybeNonemptyString(opts.Get("sort"), "conversationList sort")
+                            .value_or("priority");
+        if (sort != "priority"sv && sort != "lastRead"sv)
+            throw std::invalid_argument{"conversationList sort must be 'priority' or 'lastRead'"};
+        auto limit = toCppInteger(opts.Get("limit"), "conversationList limit", true);
+        auto offset = toCppInteger(opts.Get("offset"), "conversationList offset", true);
+        if (limit < 0 || offset < 0)
+            throw std::invalid_argument{"conversationList limit and offset must be >= 0"};
+        bool include_hidden =
+                toCppBoolean(opts.Get("includeHidden"), "conversationList includeHidden");
+
+        std::vector<Conversation> convos;
+        convos.reserve(
+                contacts.size() + user_groups.size_communities() +
+                user_groups.size_legacy_groups() + convo_info.size());
+
+        // Each kind of conversation is listed the same way: every conversation of the contacts (for
+        // 1o1s) or user groups (communities and legacy groups) config, with its volatile info if
+        // any, followed by the conversations of that kind which only have volatile info (e.g. a
+        // message request from someone who is not a contact yet, or a group or community left on
+        // another device before the volatile info was pruned).  The latter have no name and a
+        // priority of 0, so they are never hidden.
+        auto add_volatile_only = [&](std::string_view type, std::string id, const auto& info) {
+            auto& c = convos.emplace_back();
+            c.type = type;
+            c.id = std::move(id);
+            c.unread = info.unread;
+            c.last_read = info.last_read;
+        };
+
+        std::unordered_set<std::string> seen_1o1;
+        for (const auto& contact : contacts) {
+            seen_1o1.insert(contact.session_id);
+            if (contact.priority < 0 && !include_hidden)
+                continue;
+            auto& c = convos.emplace_back();
+            c.type = "1o1"sv;
+            c.id = contact.session_id;
+            if (!contact.nickname.empty())
+                c.name = contact.nickname;
+            else if (!contact.name.empty())
+                c.name = contact.name;
+            c.priority = contact.priority;
+            if (auto volatile_info = convo_info.get_1to1(contact.session_id)) {
+                c.unread = volatile_info->unread;
+                c.last_read = volatile_info->last_read;
+            }
+        }
+        for (auto it = convo_info.begin_1to1(); it != convo_info.end(); it++) {
+            const config::convo::one_to_one& volatile_info = *it;
+            if (!seen_1o1.count(volatile_info.session_id))
+                add_volatile_only("1o1"sv, volatile_info.session_id, volatile_info);
+        }
+
+        // Communities are matched by base url and normalized (lower case) room, as libsession
+        // does
+        auto community_key = [](const config::community& c) {
+            return c.base_url() + '/' + c.room_norm();
+        };
+        std::unordered_set<std::string> seen_communities;
+        for (auto it = user_groups.begin_communities(); it != user_groups.end(); it++) {
+            const config::community_info& community = *it;
+            seen_communities.insert(community_key(community));
+            if (community.priority < 0 && !include_hidden)
+                continue;
+            auto& c = convos.emplace_back();
+            c.type = "Community"sv;
+            c.id = community.full_url();
+            c.name = std::string{community.room()};
+            c.priority = community.priority;
+            if (auto volatile_info =
+                        convo_info.get_community(community.base_url(), community.room())) {
+                c.unread = volatile_info->unread;
+                c.last_read = volatile_info->last_read;
+            }
+        }
+        for (auto it = convo_info.begin_communities(); it != convo_info.end(); it++) {
+            const config::convo::community& volatile_info = *it;
+            if (!seen_communities.count(community_key(volatile_info)))
+                add_volatile_only("Community"sv, volatile_info.full_url(), volatile_info);
+        }
+
+        std::unordered_set<std::string> seen_legacy_groups;
+        for (auto it = user_groups.begin_legacy_groups(); it != user_groups.end(); it++) {
+            const config::legacy_group_info& group = *it;
+            seen_legacy_groups.insert(group.session_id);
+            if (group.priority < 0 && !include_hidden)
+                continue;
+            auto& c = convos.emplace_back();
+            c.type = "LegacyGroup"sv;
+            c.id = group.session_id;
+            if (!group.name.empty())
+                c.name = group.name;
+            c.priority = group.priority;
+            if (auto volatile_info = convo_info.get_legacy_group(group.session_id)) {
+                c.unread = volatile_info->unread;
+                c.last_read = volatile_info->last_read;
+            }
+        }
+        for (auto it = convo_info.begin_legacy_groups(); it != convo_info.end(); it++) {
+            const config::convo::legacy_group& volatile_info = *it;
+            if (!seen_legacy_groups.count(volatile_info.id))
+                add_volatile_only("LegacyGroup"sv, volatile_info.id, volatile_info);
+        }
+
+        size_t unread_count = 0, pinned_count = 0;
+        for (const auto& c : convos) {
+            if (c.unread)
+                unread_count++;
+            if (c.priority > 0)
+                pinned_count++;
+        }
+
+        // We only need the requested page to be sorted, so only sort up to its end
+        auto page_begin = std::min<size_t>(offset, convos.size());
+        auto page_end = limit > 0 ? std::min<size_t>(page_begin + limit, convos.size())
+                                  : convos.size();
+        auto by_priority = sort == "priority"sv;
+        std::partial_sort(
+                convos.begin(),
+                convos.begin() + page_end,
+                convos.end(),
+                [by_priority](const Conversation& a, const Conversation& b) {
+                    if (by_priority && a.priority != b.priority)
+                        return a.priority > b.priority;
+                    if (a.last_read != b.last_read)
+                        return a.last_read > b.last_read;
+                    return a.id < b.id;
+                });
+
+        auto page = Napi::Array::New(env, page_end - page_begin);
+        for (size_t i = page_begin; i < page_end; i++)
+            page[i - page_begin] = toJs(env, convos[i]);
+
+        auto result = Napi::Object::New(env);
+        result["conversations"] = page;
+        result["total"] = toJs(env, convos.size());
+        result["unreadCount"] = toJs(env, unread_count);
+        result["pinnedCount"] = toJs(env, pinned_count);
+        return result;
+    });
+}
+
+}  // namespace session::nodeapi
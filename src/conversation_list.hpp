@@ -0,0 +1,24 @@
+#pragma once
+
+#include <napi.h>
+
+namespace session::nodeapi {
+
+/// All-static wrapper building the conversation list (i.e. the left pane) out of the contacts, user
+/// groups and convo info volatile wrappers: the join, sort and pagination are done natively so
+/// that only the visible page gets marshalled.
+class ConversationListWrapper : public Napi::ObjectWrap<ConversationListWrapper> {
+  public:
+    ConversationListWrapper(const Napi::CallbackInfo& info) :
+            Napi::ObjectWrap<ConversationListWrapper>{info} {
+        throw std::invalid_argument(
+                "ConversationListWrapper is all static and don't need to be constructed");
+    }
+
+    static void Init(Napi::Env env, Napi::Object exports);
+
+  private:
+    static Napi::Value conversationList(const Napi::CallbackInfo& info);
+};
+
+}  // namespace session::nodeapi
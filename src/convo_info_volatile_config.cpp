@@ -4,6 +4,7 @@
 
 #include "base_config.hpp"
 #include "community.hpp"
+#include "query.hpp"
 #include "session/config/convo_info_volatile.hpp"
 #include "session/types.hpp"
 
@@ -13,40 +14,41 @@ namespace convo = config::convo;
 
 using config::ConvoInfoVolatile;
 
-template <>
-struct toJs_impl<convo::one_to_one> {
-    Napi::Object operator()(const Napi::Env& env, const convo::one_to_one& info_1o1) {
+static const QueryFields<convo::one_to_one> one_to_one_fields{
+        {"pubkeyHex", [](const convo::one_to_one& c) -> FieldValue { return c.session_id; }},
+        {"unread", [](const convo::one_to_one& c) -> FieldValue { return c.unread; }},
+        {"lastRead", [](const convo::one_to_one& c) -> FieldValue { return c.last_read; }},
+};
 
-        auto obj = Napi::Object::New(env);
+static const QueryFields<convo::legacy_group> legacy_group_fields{
+        {"pubkeyHex", [](const convo::legacy_group& c) -> FieldValue { return c.id; }},
+        {"unread", [](const convo::legacy_group& c) -> FieldValue { return c.unread; }},
+        {"lastRead", [](const convo::legacy_group& c) -> FieldValue { return c.last_read; }},
+};
 
-        obj["pubkeyHex"] = toJs(env, info_1o1.session_id);
-        obj["unread"] = toJs(env, info_1o1.unread);
-        obj["lastRead"] = toJs(env, info_1o1.last_read);
+static const auto community_fields = community_query_fields<convo::community>({
+        {"unread", [](const convo::community& c) -> FieldValue { return c.unread; }},
+        {"lastRead", [](const convo::community& c) -> FieldValue { return c.last_read; }},
+});
 
-        return obj;
+template <>
+struct toJs_impl<convo::one_to_one> {
+    Napi::Object operator()(const Napi::Env& env, const convo::one_to_one& info_1o1) {
+        return object_from_fields(env, one_to_one_fields, info_1o1);
     }
 };
 
 template <>
 struct toJs_impl<convo::legacy_group> {
-    Napi::Object operator()(const Napi::Env& env, const convo::legacy_group info_legacy) {
-        auto obj = Napi::Object::New(env);
-
-        obj["pubkeyHex"] = toJs(env, info_legacy.id);
-        obj["unread"] = toJs(env, info_legacy.unread);
-        obj["lastRead"] = toJs(env, info_legacy.last_read);
-
-        return obj;
+    Napi::Object operator()(const Napi::Env& env, const convo::legacy_group& info_legacy) {
+        return object_from_fields(env, legacy_group_fields, info_legacy);
     }
 };
 
 template <>
-struct toJs_impl<convo::community> : toJs_impl<config::community> {
-    Napi::Object operator()(const Napi::Env& env, const convo::community info_comm) {
-        auto obj = toJs_impl<config::community>::operator()(env, info_comm);
-        obj["unread"] = toJs(env, info_comm.unread);
-        obj["lastRead"] = toJs(env, info_comm.last_read);
-        return obj;
+struct toJs_impl<convo::community> {
+    Napi::Object operator()(const Napi::Env& env, const convo::community& info_comm) {
+        return object_from_fields(env, community_fields, info_comm);
     }
 };
 
@@ -59,6 +61,7 @@ void ConvoInfoVolatileWrapper::Init(Napi::Env env, Napi::Object exports) {
                     // 1o1 related methods
                     InstanceMethod("get1o1", &ConvoInfoVolatileWrapper::get1o1),
                     InstanceMethod("getAll1o1", &ConvoInfoVolatileWrapper::getAll1o1),
+                    InstanceMethod("query1o1", &ConvoInfoVolatileWrapper::query1o1),
                     InstanceMethod("set1o1", &ConvoInfoVolatileWrapper::set1o1),
                     InstanceMethod("erase1o1", &ConvoInfoVolatileWrapper::erase1o1),
 
@@ -66,6 +69,8 @@ void ConvoInfoVolatileWrapper::Init(Napi::Env env, Napi::Object exports) {
                     InstanceMethod("getLegacyGroup", &ConvoInfoVolatileWrapper::getLegacyGroup),
                     InstanceMethod(
                             "getAllLegacyGroups", &ConvoInfoVolatileWrapper::getAllLegacyGroups),
+                    InstanceMethod(
+                            "queryLegacyGroups", &ConvoInfoVolatileWrapper::queryLegacyGroups),
                     InstanceMethod("setLegacyGroup", &ConvoInfoVolatileWrapper::setLegacyGroup),
                     InstanceMethod("eraseLegacyGroup", &ConvoInfoVolatileWrapper::eraseLegacyGroup),
 
@@ -73,18 +78,24 @@ void ConvoInfoVolatileWrapper::Init(Napi::Env env, Napi::Object exports) {
                     InstanceMethod("getCommunity", &ConvoInfoVolatileWrapper::getCommunity),
                     InstanceMethod(
                             "getAllCommunities", &ConvoInfoVolatileWrapper::getAllCommunities),
+                    InstanceMethod(
+                            "queryCommunities", &ConvoInfoVolatileWrapper::queryCommunities),
                     InstanceMethod(
                             "setCommunityByFullUrl",
                             &ConvoInfoVolatileWrapper::setCommunityByFullUrl),
                     InstanceMethod(
                             "eraseCommunityByFullUrl",
                             &ConvoInfoVolatileWrapper::eraseCommunityByFullUrl),
+
+                    InstanceMethod("exportReadOnly", &ConvoInfoVolatileWrapper::exportReadOnly),
             });
 }
 
 ConvoInfoVolatileWrapper::ConvoInfoVolatileWrapper(const Napi::CallbackInfo& info) :
         ConfigBaseImpl{construct<ConvoInfoVolatile>(info, "ConvoInfoVolatile")},
-        Napi::ObjectWrap<ConvoInfoVolatileWrapper>{info} {}
+        Napi::ObjectWrap<ConvoInfoVolatileWrapper>{info} {
+    tagInstance<ConvoInfoVolatileWrapper>(info);
+}
 
 /**
  * =================================================
@@ -93,11 +104,16 @@ ConvoInfoVolatileWrapper::ConvoInfoVolatileWrapper(const Napi::CallbackInfo& inf
  */
 
 Napi::Value ConvoInfoVolatileWrapper::get1o1(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.get_1to1(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] { return config().get_1to1(getStringArgs<1>(info)); });
 }
 
 Napi::Value ConvoInfoVolatileWrapper::getAll1o1(const Napi::CallbackInfo& info) {
-    return get_all_impl(info, config.size_1to1(), config.begin_1to1(), config.end());
+    return get_all_impl(info, config().size_1to1(), config().begin_1to1(), config().end());
+}
+
+Napi::Value ConvoInfoVolatileWrapper::query1o1(const Napi::CallbackInfo& info) {
+    return query_impl(
+            info, one_to_one_fields, config().begin_1to1(), config().end(), "convoInfo.query1o1");
 }
 
 void ConvoInfoVolatileWrapper::set1o1(const Napi::CallbackInfo& info) {
@@ -112,14 +128,15 @@ void ConvoInfoVolatileWrapper::set1o1(const Napi::CallbackInfo& info) {
         auto third = info[2];
         assertIsBoolean(third);
 
-        auto convo = config.get_or_construct_1to1(toCppString(first, "convoInfo.set1o1"));
+        auto convo = config().get_or_construct_1to1(toCppString(first, "convoInfo.set1o1"));
 
         if (auto last_read = toCppInteger(second, "convoInfo.set1o1_2");
             last_read > convo.last_read)
             convo.last_read = last_read;
         convo.unread = toCppBoolean(third, "convoInfo.set1o1_3");
 
-        config.set(convo);
+        Mutation mutation{*this};
+        config().set(convo);
     });
 }
 
@@ -130,12 +147,21 @@ void ConvoInfoVolatileWrapper::set1o1(const Napi::CallbackInfo& info) {
  */
 
 Napi::Value ConvoInfoVolatileWrapper::getLegacyGroup(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.get_legacy_group(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] { return config().get_legacy_group(getStringArgs<1>(info)); });
 }
 
 Napi::Value ConvoInfoVolatileWrapper::getAllLegacyGroups(const Napi::CallbackInfo& info) {
     return get_all_impl(
-            info, config.size_legacy_groups(), config.begin_legacy_groups(), config.end());
+            info, config().size_legacy_groups(), config().begin_legacy_groups(), config().end());
+}
+
+Napi::Value ConvoInfoVolatileWrapper::queryLegacyGroups(const Napi::CallbackInfo& info) {
+    return query_impl(
+            info,
+            legacy_group_fields,
+            config().begin_legacy_groups(),
+            config().end(),
+            "convoInfo.queryLegacyGroups");
 }
 
 void ConvoInfoVolatileWrapper::setLegacyGroup(const Napi::CallbackInfo& info) {
@@ -149,7 +175,7 @@ void ConvoInfoVolatileWrapper::setLegacyGroup(const Napi::CallbackInfo& info) {
         auto third = info[2];
         assertIsBoolean(third);
 
-        auto convo = config.get_or_construct_legacy_group(
+        auto convo = config().get_or_construct_legacy_group(
                 toCppString(first, "convoInfo.SetLegacyGroup1"));
 
         if (auto last_read = toCppInteger(second, "convoInfo.SetLegacyGroup2");
@@ -158,16 +184,25 @@ void ConvoInfoVolatileWrapper::setLegacyGroup(const Napi::CallbackInfo& info) {
 
         convo.unread = toCppBoolean(third, "convoInfo.SetLegacyGroup3");
 
-        config.set(convo);
+        Mutation mutation{*this};
+        config().set(convo);
     });
 }
 
 Napi::Value ConvoInfoVolatileWrapper::eraseLegacyGroup(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.erase_legacy_group(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] {
+        Mutation mutation{*this};
+        auto erased = config().erase_legacy_group(getStringArgs<1>(info));
+        return erased;
+    });
 }
 
 Napi::Value ConvoInfoVolatileWrapper::erase1o1(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.erase_1to1(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] {
+        Mutation mutation{*this};
+        auto erased = config().erase_1to1(getStringArgs<1>(info));
+        return erased;
+    });
 }
 
 /**
@@ -177,11 +212,21 @@ Napi::Value ConvoInfoVolatileWrapper::erase1o1(const Napi::CallbackInfo& info) {
  */
 
 Napi::Value ConvoInfoVolatileWrapper::getCommunity(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.get_community(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] { return config().get_community(getStringArgs<1>(info)); });
 }
 
 Napi::Value ConvoInfoVolatileWrapper::getAllCommunities(const Napi::CallbackInfo& info) {
-    return get_all_impl(info, config.size_communities(), config.begin_communities(), config.end());
+    return get_all_impl(
+            info, config().size_communities(), config().begin_communities(), config().end());
+}
+
+Napi::Value ConvoInfoVolatileWrapper::queryCommunities(const Napi::CallbackInfo& info) {
+    return query_impl(
+            info,
+            community_fields,
+            config().begin_communities(),
+            config().end(),
+            "convoInfo.queryCommunities");
 }
 
 // TODO maybe make the setXXX   return the update value so we avoid having to
@@ -199,7 +244,7 @@ void ConvoInfoVolatileWrapper::setCommunityByFullUrl(const Napi::CallbackInfo& i
         auto third = info[2];
         assertIsBoolean(third);
 
-        auto convo = config.get_or_construct_community(
+        auto convo = config().get_or_construct_community(
                 toCppString(first, "convoInfo.SetCommunityByFullUrl1"));
 
         if (auto last_read = toCppInteger(second, "convoInfo.SetCommunityByFullUrl2");
@@ -211,15 +256,143 @@ void ConvoInfoVolatileWrapper::setCommunityByFullUrl(const Napi::CallbackInfo& i
         // Note: we only keep the messages read when their timestamp is not older
         // than 30 days or so (see libsession util PRUNE constant). so this `set()`
         // here might actually not create an entry
-        config.set(convo);
+        Mutation mutation{*this};
+        config().set(convo);
     });
 }
 
 Napi::Value ConvoInfoVolatileWrapper::eraseCommunityByFullUrl(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&] {
         auto [base, room, pubkey] = config::community::parse_full_url(getStringArgs<1>(info));
-        return config.erase_community(base, room);
+        Mutation mutation{*this};
+        auto erased = config().erase_community(base, room);
+        return erased;
+    });
+}
+
+/**
+ * =================================================
+ * =================== Read-only ===================
+ * =================================================
+ */
+
+struct ConvoInfoVolatileReadOnlyData : ReadOnlyRegistry::Data {
+    // In libsession's order, for lookups
+    std::vector<convo::one_to_one> one_to_ones;
+    std::vector<convo::legacy_group> legacy_groups;
+    std::vector<convo::community> communities;
+};
+
+namespace {
+
+    const std::string& one_to_one_id(const convo::one_to_one& c) {
+        return c.session_id;
+    }
+    const std::string& legacy_group_id(const convo::legacy_group& c) {
+        return c.id;
+    }
+
+}  // namespace
+
+Napi::Value ConvoInfoVolatileWrapper::exportReadOnly(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        auto data = std::make_shared<ConvoInfoVolatileReadOnlyData>();
+        auto& conf = config();
+        data->one_to_ones =
+                copy_sorted<convo::one_to_one>(conf.begin_1to1(), conf.end(), one_to_one_id);
+        data->legacy_groups = copy_sorted<convo::legacy_group>(
+                conf.begin_legacy_groups(), conf.end(), legacy_group_id);
+        data->communities = copy_sorted<convo::community>(
+                conf.begin_communities(), conf.end(), community_key<convo::community>);
+        return ConvoInfoVolatileReadOnlyWrapper::create(info.Env(), data);
+    });
+}
+
+void ConvoInfoVolatileReadOnlyWrapper::Init(Napi::Env env, Napi::Object exports) {
+    InitClass(
+            env,
+            exports,
+            "ConvoInfoVolatileReadOnlyNode",
+            {
+                    InstanceMethod("get1o1", &ConvoInfoVolatileReadOnlyWrapper::get1o1),
+                    InstanceMethod("getAll1o1", &ConvoInfoVolatileReadOnlyWrapper::getAll1o1),
+                    InstanceMethod(
+                            "getLegacyGroup", &ConvoInfoVolatileReadOnlyWrapper::getLegacyGroup),
+                    InstanceMethod(
+                            "getAllLegacyGroups",
+                            &ConvoInfoVolatileReadOnlyWrapper::getAllLegacyGroups),
+                    InstanceMethod(
+                            "getCommunity", &ConvoInfoVolatileReadOnlyWrapper::getCommunity),
+                    InstanceMethod(
+                            "getAllCommunities",
+                            &ConvoInfoVolatileReadOnlyWrapper::getAllCommunities),
+            });
+}
+
+Napi::Value ConvoInfoVolatileReadOnlyWrapper::get1o1(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        return find_sorted(data_->one_to_ones, one_to_one_id, getStringArgs<1>(info));
+    });
+}
+
+Napi::Value ConvoInfoVolatileReadOnlyWrapper::getAll1o1(const Napi::CallbackInfo& info) {
+    return get_all_impl(
+            info, data_->one_to_ones.size(), data_->one_to_ones.begin(), data_->one_to_ones.end());
+}
+
+Napi::Value ConvoInfoVolatileReadOnlyWrapper::getLegacyGroup(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        return find_sorted(data_->legacy_groups, legacy_group_id, getStringArgs<1>(info));
+    });
+}
+
+Napi::Value ConvoInfoVolatileReadOnlyWrapper::getAllLegacyGroups(const Napi::CallbackInfo& info) {
+    return get_all_impl(
+            info,
+            data_->legacy_groups.size(),
+            data_->legacy_groups.begin(),
+            data_->legacy_groups.end());
+}
+
+Napi::Value ConvoInfoVolatileReadOnlyWrapper::getCommunity(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        // Same matching as libsession: the base url is normalized by parsing, the room is case
+        // insensitive
+        auto [base, room, pubkey] = config::community::parse_full_url(getStringArgs<1>(info));
+        auto room_norm = community_room_norm(room);
+        return find_sorted(
+                data_->communities,
+                community_key<convo::community>,
+                CommunityKey{base, room_norm});
     });
 }
 
+Napi::Value ConvoInfoVolatileReadOnlyWrapper::getAllCommunities(const Napi::CallbackInfo& info) {
+    return get_all_impl(
+            info,
+            data_->communities.size(),
+            data_->communities.begin(),
+            data_->communities.end());
+}
+
+auto ConvoInfoVolatileWrapper::collectionUsage() -> std::vector<CollectionUsage> {
+    CollectionUsage one_to_ones{"oneToOnes"}, communities{"communities"},
+            legacy_groups{"legacyGroups"};
+    for (auto it = config().begin_1to1(); it != config().end(); it++) {
+        one_to_ones.entries++;
+        one_to_ones.bytes += sizeof(*it) + it->session_id.size();
+    }
+    for (auto it = config().begin_communities(); it != config().end(); it++) {
+        communities.entries++;
+        // (+ the pubkey, which is kept as bytes)
+        communities.bytes += sizeof(*it) + it->base_url().size() + it->room().size() + 32;
+    }
+    for (auto it = config().begin_legacy_groups(); it != config().end(); it++) {
+        legacy_groups.entries++;
+        legacy_groups.bytes += sizeof(*it) + it->id.size();
+    }
+    return {one_to_ones, communities, legacy_groups};
+}
+
 }  // namespace session::nodeapi
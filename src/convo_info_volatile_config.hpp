@@ -2,7 +2,10 @@
 
 #include <napi.h>
 
+#include <memory>
+
 #include "base_config.hpp"
+#include "readonly_registry.hpp"
 #include "session/config/convo_info_volatile.hpp"
 
 namespace session::nodeapi {
@@ -15,25 +18,53 @@ class ConvoInfoVolatileWrapper : public ConfigBaseImpl,
     explicit ConvoInfoVolatileWrapper(const Napi::CallbackInfo& info);
 
   private:
-    config::ConvoInfoVolatile& config{get_config<config::ConvoInfoVolatile>()};
+    config::ConvoInfoVolatile& config() { return get_config<config::ConvoInfoVolatile>(); }
+
+    std::vector<CollectionUsage> collectionUsage() override;
 
     // 1o1 related methods
     Napi::Value get1o1(const Napi::CallbackInfo& info);
     Napi::Value getAll1o1(const Napi::CallbackInfo& info);
+    Napi::Value query1o1(const Napi::CallbackInfo& info);
     void set1o1(const Napi::CallbackInfo& info);
     Napi::Value erase1o1(const Napi::CallbackInfo& info);
 
     // legacy group related methods
     Napi::Value getLegacyGroup(const Napi::CallbackInfo& info);
     Napi::Value getAllLegacyGroups(const Napi::CallbackInfo& info);
+    Napi::Value queryLegacyGroups(const Napi::CallbackInfo& info);
     void setLegacyGroup(const Napi::CallbackInfo& info);
     Napi::Value eraseLegacyGroup(const Napi::CallbackInfo& info);
 
     // communities related methods
     Napi::Value getCommunity(const Napi::CallbackInfo& info);
     Napi::Value getAllCommunities(const Napi::CallbackInfo& info);
+    Napi::Value queryCommunities(const Napi::CallbackInfo& info);
     void setCommunityByFullUrl(const Napi::CallbackInfo& info);
     Napi::Value eraseCommunityByFullUrl(const Napi::CallbackInfo& info);
+
+    Napi::Value exportReadOnly(const Napi::CallbackInfo& info);
+};
+
+struct ConvoInfoVolatileReadOnlyData;
+
+/// Immutable copy of the conversations info, returned by
+/// `ConvoInfoVolatileWrapper.exportReadOnly()` and opened from any thread by its handle (see
+/// ReadOnlyWrapper).
+class ConvoInfoVolatileReadOnlyWrapper
+        : public ReadOnlyWrapper<ConvoInfoVolatileReadOnlyWrapper, ConvoInfoVolatileReadOnlyData> {
+  public:
+    static void Init(Napi::Env env, Napi::Object exports);
+
+    using ReadOnlyWrapper::ReadOnlyWrapper;
+
+  private:
+    Napi::Value get1o1(const Napi::CallbackInfo& info);
+    Napi::Value getAll1o1(const Napi::CallbackInfo& info);
+    Napi::Value getLegacyGroup(const Napi::CallbackInfo& info);
+    Napi::Value getAllLegacyGroups(const Napi::CallbackInfo& info);
+    Napi::Value getCommunity(const Napi::CallbackInfo& info);
+    Napi::Value getAllCommunities(const Napi::CallbackInfo& info);
 };
 
 }  // namespace session::nodeapi
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <napi.h>
+
+#include <cstdint>
+
+namespace session::nodeapi {
+
+/// Tells V8 how much native memory a wrapper holds, so that garbage collection accounts for it.
+/// What was reported is given back on destruction.
+class ExternalMemory {
+  public:
+    // Local changes only update the reported size every this many changes, as measuring it walks
+    // through the whole config.
+    static constexpr uint32_t INTERVAL = 64;
+
+    // Reports `initial_size` right away; a null `env` disables reporting.
+    ExternalMemory(napi_env env, size_t initial_size) : env_{env} {
+        if (env_ && initial_size)
+            report(initial_size);
+    }
+
+    ~ExternalMemory() {
+        if (env_ && reported_)
+            Napi::MemoryManagement::AdjustExternalMemory(Napi::Env{env_}, -reported_);
+    }
+
+    ExternalMemory(const ExternalMemory&) = delete;
+    ExternalMemory& operator=(const ExternalMemory&) = delete;
+
+    // Whether the size should be measured again at this mutation count: always if `force` is set,
+    // otherwise once enough changes were made since the last report.
+    bool due(uint32_t mutation_count, bool force) {
+        if (!env_)
+            return false;
+        if (!force && mutation_count - mutation_count_ < INTERVAL)
+            return false;
+        mutation_count_ = mutation_count;
+        return true;
+    }
+
+    // Reports `size` (as an adjustment of what was reported before).
+    void report(size_t size) {
+        auto bytes = static_cast<int64_t>(size);
+        if (bytes != reported_) {
+            Napi::MemoryManagement::AdjustExternalMemory(Napi::Env{env_}, bytes - reported_);
+            reported_ = bytes;
+        }
+    }
+
+  private:
+    napi_env env_;
+    int64_t reported_ = 0;
+    uint32_t mutation_count_ = 0;
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,38 @@
+#include "log_queue.hpp"
+
+#include <utility>
+
+namespace session::nodeapi {
+
+namespace {
+
+    void console_log(Napi::Env env, const std::string& line) {
+        Napi::Function consoleLog =
+                env.Global().Get("console").As<Napi::Object>().Get("log").As<Napi::Function>();
+        consoleLog.Call({Napi::String::New(env, line)});
+    }
+
+}  // namespace
+
+void LogQueue::log(std::string line) {
+    if (std::this_thread::get_id() != js_thread_) {
+        std::lock_guard lock{mutex_};
+        pending_.push_back(std::move(line));
+        return;
+    }
+
+    flush();
+    console_log(Napi::Env{env_}, line);
+}
+
+void LogQueue::flush() {
+    std::vector<std::string> lines;
+    {
+        std::lock_guard lock{mutex_};
+        lines.swap(pending_);
+    }
+    for (const auto& line : lines)
+        console_log(Napi::Env{env_}, line);
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <napi.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace session::nodeapi {
+
+/// The libsession log lines of one wrapper (or actor).  libsession logs from whichever thread works
+/// on a config, but console.log can only be called from the JS thread: the lines logged from any
+/// other thread wait here until the JS thread flushes them.  Each owner has its own queue, so that
+/// a flush only writes out (and only locks) the lines of its own configs.
+class LogQueue {
+  public:
+    // Must be constructed on the JS thread of `env`.
+    explicit LogQueue(napi_env env) : env_{env}, js_thread_{std::this_thread::get_id()} {}
+
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+
+    // Writes `line` out right away when called from the JS thread (after the queued lines), and
+    // queues it from any other thread.
+    void log(std::string line);
+
+    // Writes out the queued lines.  JS thread only.
+    void flush();
+
+  private:
+    napi_env env_;
+    std::thread::id js_thread_;
+    std::mutex mutex_;
+    std::vector<std::string> pending_;
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,188 @@
+#include "merge_ingestor.hpp"
+
+#include <uv.h>
+
+#include <optional>
+#include <stdexcept>
+
+#include "utilities.hpp"
+
+namespace session::nodeapi {
+
+namespace {
+
+    struct Batch {
+        std::vector<std::pair<std::string, ustring>> msgs;
+        size_t bytes = 0;
+    };
+
+}  // namespace
+
+struct MergeIngestor::State {
+    MergeIngestor::Options options;
+    MergeIngestor::Merge merge;
+    Napi::FunctionReference listener;
+    Napi::Env env;
+
+    // Fires once the first buffered message waited `max_delay_ms`, or right away once a batch was
+    // dispatched (to merge it)
+    uv_timer_t* timer;
+    bool timer_active = false;
+
+    Batch buffer;
+    // The batch dispatched, merged when the timer fires
+    Batch in_flight;
+    bool dispatched = false;
+    bool ending = false;
+
+    explicit State(Napi::Env env) : env{env} {}
+
+    bool full() const {
+        return buffer.msgs.size() >= options.max_batch_messages ||
+               buffer.bytes >= options.max_batch_bytes;
+    }
+    bool writable() const { return buffer.bytes + in_flight.bytes < options.high_water_bytes; }
+    bool idle() const { return !dispatched && buffer.msgs.empty(); }
+
+    void start_timer(uint64_t delay_ms) {
+        if (timer_active)
+            return;
+        timer_active = true;
+        uv_timer_start(
+                timer,
+                [](uv_timer_t* t) {
+                    auto* state = static_cast<State*>(t->data);
+                    state->timer_active = false;
+                    // (not called from JS, so there is no scope for the event's handles yet)
+                    Napi::HandleScope scope{state->env};
+                    if (state->dispatched)
+                        state->merge_batch();
+                    else if (!state->buffer.msgs.empty())
+                        state->dispatch();
+                },
+                delay_ms,
+                0);
+    }
+
+    void stop_timer() {
+        uv_timer_stop(timer);
+        timer_active = false;
+    }
+
+    void dispatch();
+    void merge_batch();
+};
+
+// The batch isn't merged right away, so that the writer gets to return (and to keep writing, into
+// the next batch) first.
+void MergeIngestor::State::dispatch() {
+    stop_timer();
+    in_flight = std::move(buffer);
+    buffer = Batch{};
+    dispatched = true;
+    start_timer(0);
+}
+
+void MergeIngestor::State::merge_batch() {
+    Batch batch = std::move(in_flight);
+    in_flight = Batch{};
+    dispatched = false;
+
+    std::vector<std::pair<std::string, ustring_view>> msgs;
+    msgs.reserve(batch.msgs.size());
+    for (const auto& [hash, data] : batch.msgs)
+        msgs.emplace_back(hash, data);
+
+    std::vector<std::string> merged;
+    std::optional<std::string> error;
+    try {
+        merged = merge(msgs);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    // libsession drops the messages it fails to decrypt or parse, each on its own
+    size_t undecryptable = error ? 0 : msgs.size() - merged.size();
+    msgs.clear();
+    batch = Batch{};
+
+    // The next batch goes right away if it is ready, so that the writer is not kept waiting
+    if (!buffer.msgs.empty()) {
+        if (full() || ending)
+            dispatch();
+        else
+            start_timer(options.max_delay_ms);
+    }
+
+    auto event = Napi::Object::New(env);
+    event["merged"] = toJs(env, merged);
+    event["undecryptable"] = toJs(env, undecryptable);
+    event["writable"] = toJs(env, writable());
+    event["done"] = toJs(env, ending && idle());
+    if (error)
+        event["error"] = toJs(env, *error);
+    // Last, as the listener may destroy the ingestor (by starting another stream).  We are called
+    // from the event loop, with nothing to throw to: what the listener throws is reported as an
+    // uncaught exception.
+    try {
+        listener.MakeCallback(env.Global(), {event});
+    } catch (const Napi::Error& e) {
+        napi_fatal_exception(env, e.Value());
+    }
+}
+
+MergeIngestor::MergeIngestor(
+        Napi::Env env, Options options, Merge merge, Napi::Function listener) :
+        state_{std::make_unique<State>(env)} {
+    state_->options = options;
+    state_->merge = std::move(merge);
+    state_->listener = Napi::Persistent(listener);
+
+    uv_loop_t* loop;
+    if (napi_get_uv_event_loop(env, &loop) != napi_ok)
+        throw std::runtime_error{"MergeIngestor: failed to get the event loop"};
+    state_->timer = new uv_timer_t;
+    uv_timer_init(loop, state_->timer);
+    state_->timer->data = state_.get();
+}
+
+MergeIngestor::~MergeIngestor() {
+    // The batch dispatched, if any, is dropped along with the buffer
+    state_->stop_timer();
+    uv_close(reinterpret_cast<uv_handle_t*>(state_->timer), [](uv_handle_t* handle) {
+        delete reinterpret_cast<uv_timer_t*>(handle);
+    });
+}
+
+bool MergeIngestor::write(std::string hash, ustring data) {
+    auto& state = *state_;
+    if (state.ending)
+        throw std::logic_error{"ingest: the stream was already ended"};
+
+    state.buffer.bytes += data.size();
+    state.buffer.msgs.emplace_back(std::move(hash), std::move(data));
+    if (!state.dispatched) {
+        if (state.full())
+            state.dispatch();
+        else
+            state.start_timer(state.options.max_delay_ms);
+    }
+    return state.writable();
+}
+
+bool MergeIngestor::end() {
+    auto& state = *state_;
+    state.ending = true;
+    if (!state.dispatched && !state.buffer.msgs.empty())
+        state.dispatch();
+    return state.idle();
+}
+
+bool MergeIngestor::done() const {
+    return state_->ending && state_->idle();
+}
+
+size_t MergeIngestor::pendingBytes() const {
+    return state_->buffer.bytes + state_->in_flight.bytes;
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <napi.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "session/types.hpp"
+
+namespace session::nodeapi {
+
+/// Merges config messages into a config as they are written, rather than all at once: messages are
+/// buffered until there are enough of them (or some time passed), then the batch is merged on the
+/// next turn of the event loop.  Messages written meanwhile are buffered for the next batch;
+/// `write` returns false once too much is buffered, and the writer should then wait for a listener
+/// event saying the ingestor is writable again.
+///
+/// The listener is called after each batch with
+/// `{merged: string[], undecryptable: number, writable: boolean, done: boolean, error?: string}`,
+/// `undecryptable` counting the messages libsession did not merge, and `done` being set once
+/// `end()` was called and every message was merged.
+class MergeIngestor {
+  public:
+    struct Options {
+        size_t max_batch_messages = 256;
+        size_t max_batch_bytes = 1 << 20;
+        uint64_t max_delay_ms = 50;
+        // Writes return false while at least this many bytes are buffered or being merged
+        size_t high_water_bytes = 4 << 20;
+    };
+
+    // Merges the messages of a batch into the config, returning the hashes merged
+    using Merge = std::function<std::vector<std::string>(
+            const std::vector<std::pair<std::string, ustring_view>>& msgs)>;
+
+    MergeIngestor(Napi::Env env, Options options, Merge merge, Napi::Function listener);
+    ~MergeIngestor();
+
+    MergeIngestor(const MergeIngestor&) = delete;
+    MergeIngestor& operator=(const MergeIngestor&) = delete;
+
+    // Buffers a message.  Returns false if the writer should wait for the ingestor to become
+    // writable again.  Throws std::logic_error after `end()`.
+    bool write(std::string hash, ustring data);
+
+    // Merges whatever is left.  Returns true if that was nothing, i.e. there won't be a `done`
+    // event because everything was already merged.
+    bool end();
+
+    // True once `end()` was called and everything was merged.
+    bool done() const;
+
+    // The size of the messages buffered or being merged.
+    size_t pendingBytes() const;
+
+    struct State;
+
+  private:
+    std::unique_ptr<State> state_;
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,620 @@
+#include "meta_group_wrapper.hpp"
+
+#include <oxenc/bt_producer.h>
+#include <oxenc/bt_serialize.h>
+
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "profile_pic.hpp"
+#include "utilities.hpp"
+
+namespace session::nodeapi {
+
+using config::groups::member;
+using Mutation = GroupConfigImpl::Mutation;
+
+template <>
+struct toJs_impl<member> {
+    Napi::Object operator()(const Napi::Env& env, const member& m) {
+        auto obj = Napi::Object::New(env);
+
+        obj["pubkeyHex"] = toJs(env, m.session_id);
+        obj["name"] = toJs(env, maybe_string(m.name));
+        obj["profilePicture"] = object_from_profile_pic(env, m.profile_picture);
+        obj["admin"] = toJs(env, m.admin);
+        obj["invitePending"] = toJs(env, m.invite_pending());
+        obj["inviteFailed"] = toJs(env, m.invite_failed());
+        obj["promotionPending"] = toJs(env, m.promotion_pending());
+        obj["promotionFailed"] = toJs(env, m.promotion_failed());
+        obj["promoted"] = toJs(env, m.promoted());
+
+        return obj;
+    }
+};
+
+namespace {
+
+    std::vector<std::string> pubkeys_arg(Napi::Value val, const std::string& identifier) {
+        assertIsArray(val);
+        auto arr = val.As<Napi::Array>();
+        std::vector<std::string> pubkeys;
+        pubkeys.reserve(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); i++)
+            pubkeys.push_back(toCppString(arr.Get(i), identifier));
+        return pubkeys;
+    }
+
+    // Applies `f` to each of the given members and saves them.  Nothing is changed if any of them
+    // is not a member of the group.
+    template <typename F>
+    void update_members(
+            GroupConfigImpl& impl,
+            config::groups::Members& members,
+            const std::vector<std::string>& pubkeys,
+            const std::string& identifier,
+            F&& f) {
+        std::vector<member> found;
+        found.reserve(pubkeys.size());
+        for (const auto& pubkey : pubkeys) {
+            auto m = members.get(pubkey);
+            if (!m)
+                throw std::invalid_argument{identifier + ": " + pubkey + " is not a member"};
+            found.push_back(std::move(*m));
+        }
+        Mutation mutation{impl};
+        for (auto& m : found) {
+            f(m);
+            members.set(m);
+        }
+    }
+
+    std::vector<std::pair<std::string, ustring_view>> messages_arg(
+            Napi::Value val, const std::string& identifier) {
+        std::vector<std::pair<std::string, ustring_view>> msgs;
+        if (val.IsUndefined() || val.IsNull())
+            return msgs;
+        assertIsArray(val);
+        auto arr = val.As<Napi::Array>();
+        msgs.reserve(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            auto item = arr.Get(i);
+            assertIsObject(item);
+            auto obj = item.As<Napi::Object>();
+            msgs.emplace_back(
+                    toCppString(obj.Get("hash"), identifier),
+                    toCppBufferView(obj.Get("data"), identifier));
+        }
+        return msgs;
+    }
+
+    Napi::Value config_push(Napi::Env env, GroupConfigImpl& impl) {
+        if (!impl.needsPushConfig())
+            return env.Null();
+        auto [seqno, data, hashes] = impl.pushConfig();
+        impl.updateStatus();
+        auto obj = Napi::Object::New(env);
+        obj["data"] = toJs(env, data);
+        obj["seqno"] = toJs(env, seqno);
+        obj["hashes"] = toJs(env, hashes);
+        obj["namespace"] = toJs(env, impl.storageNamespaceConfig());
+        return obj;
+    }
+
+    void config_confirm(GroupConfigImpl& impl, Napi::Value val, const std::string& identifier) {
+        if (val.IsUndefined() || val.IsNull())
+            return;
+        assertIsObject(val);
+        auto obj = val.As<Napi::Object>();
+        assertIsNumber(obj.Get("seqno"));
+        assertIsString(obj.Get("hash"));
+        impl.confirmPushedConfig(
+                toCppInteger(obj.Get("seqno"), identifier, false),
+                toCppString(obj.Get("hash"), identifier));
+    }
+
+    std::string_view as_string_view(ustring_view data) {
+        return {reinterpret_cast<const char*>(data.data()), data.size()};
+    }
+
+}  // namespace
+
+void MetaGroupWrapper::Init(Napi::Env env, Napi::Object exports) {
+    NoBaseClassInitHelper<MetaGroupWrapper>(
+            env,
+            exports,
+            "MetaGroupWrapperNode",
+            {
+                    // combined methods
+                    InstanceMethod("needsPush", &MetaGroupWrapper::needsPush),
+                    InstanceMethod("needsDump", &MetaGroupWrapper::needsDump),
+                    InstanceMethod("push", &MetaGroupWrapper::push),
+                    InstanceMethod("dump", &MetaGroupWrapper::dump),
+                    InstanceMethod("confirmPushed", &MetaGroupWrapper::confirmPushed),
+                    InstanceMethod("merge", &MetaGroupWrapper::merge),
+                    InstanceMethod("statusBlock", &MetaGroupWrapper::statusBlock),
+                    InstanceMethod("onChange", &MetaGroupWrapper::onChange),
+                    InstanceMethod("autoPersist", &MetaGroupWrapper::autoPersist),
+                    InstanceMethod("flushPersist", &MetaGroupWrapper::flushPersist),
+
+                    // info related methods
+                    InstanceMethod("infoGet", &MetaGroupWrapper::infoGet),
+                    InstanceMethod("infoSet", &MetaGroupWrapper::infoSet),
+                    InstanceMethod("infoDestroy", &MetaGroupWrapper::infoDestroy),
+
+                    // members related methods
+                    InstanceMethod("memberGet", &MetaGroupWrapper::memberGet),
+                    InstanceMethod("memberGetAll", &MetaGroupWrapper::memberGetAll),
+                    InstanceMethod("membersAdd", &MetaGroupWrapper::membersAdd),
+                    InstanceMethod("membersSetInvited", &MetaGroupWrapper::membersSetInvited),
+                    InstanceMethod("membersSetAccepted", &MetaGroupWrapper::membersSetAccepted),
+                    InstanceMethod("membersSetPromoted", &MetaGroupWrapper::membersSetPromoted),
+                    InstanceMethod("membersRemove", &MetaGroupWrapper::membersRemove),
+
+                    // keys related methods
+                    InstanceMethod("keysAdmin", &MetaGroupWrapper::keysAdmin),
+                    InstanceMethod("keysNeedsRekey", &MetaGroupWrapper::keysNeedsRekey),
+                    InstanceMethod("keysRekey", &MetaGroupWrapper::keysRekey),
+            });
+}
+
+MetaGroupWrapper::MetaGroupWrapper(const Napi::CallbackInfo& info) :
+        Napi::ObjectWrap<MetaGroupWrapper>{info},
+        group_{constructGroupWrapper(info, "MetaGroupWrapper")},
+        info_impl_{group_.info, group_.logs, info.Env(), [this] { configChanged(); }},
+        members_impl_{group_.members, group_.logs, info.Env(), [this] { configChanged(); }} {
+    info.This().As<Napi::Object>().TypeTag(wrapper_type_tag<MetaGroupWrapper>());
+}
+
+MetaGroupWrapper* MetaGroupWrapper::maybeUnwrap(Napi::Value val) {
+    if (!val.IsObject() ||
+        !val.As<Napi::Object>().CheckTypeTag(wrapper_type_tag<MetaGroupWrapper>()))
+        return nullptr;
+    return Unwrap(val.As<Napi::Object>());
+}
+
+MetaGroupWrapper::MetaGroup MetaGroupWrapper::constructGroupWrapper(
+        const Napi::CallbackInfo& info, const std::string& class_name) {
+    return wrapExceptions(info, [&] {
+        if (!info.IsConstructCall())
+            throw std::invalid_argument{"You need to call the constructor with the `new` syntax"};
+
+        assertInfoLength(info, 1);
+        assertIsObject(info[0]);
+        auto obj = info[0].As<Napi::Object>();
+
+        auto user_sk = toCppBuffer(
+                obj.Get("userEd25519Secretkey"), class_name + ".new.userEd25519Secretkey");
+        auto group_pk =
+                toCppBuffer(obj.Get("groupEd25519Pubkey"), class_name + ".new.groupEd25519Pubkey");
+        auto group_sk = maybeNonemptyBuffer(
+                obj.Get("groupEd25519Secretkey"), class_name + ".new.groupEd25519Secretkey");
+        auto meta_dump = maybeNonemptyBuffer(obj.Get("metaDumped"), class_name + ".new.metaDumped");
+
+        std::optional<ustring_view> info_dump, keys_dump, members_dump;
+        if (meta_dump) {
+            oxenc::bt_dict_consumer combined{as_string_view(*meta_dump)};
+            auto next = [&](std::string_view key, std::optional<ustring_view>& dump) {
+                if (combined.skip_until(key)) {
+                    auto str = combined.consume_string_view();
+                    dump.emplace(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+                }
+            };
+            // (the keys of a bt dict must be read in order)
+            next("info", info_dump);
+            next("keys", keys_dump);
+            next("members", members_dump);
+        }
+
+        std::optional<ustring_view> group_sk_view;
+        if (group_sk)
+            group_sk_view = *group_sk;
+
+        MetaGroup group;
+        group.info = std::make_shared<config::groups::Info>(group_pk, group_sk_view, info_dump);
+        group.members =
+                std::make_shared<config::groups::Members>(group_pk, group_sk_view, members_dump);
+        group.keys = std::make_shared<config::groups::Keys>(
+                user_sk, group_pk, group_sk_view, keys_dump, *group.info, *group.members);
+
+        group.logs = std::make_shared<LogQueue>(info.Env());
+        auto logger = [logs = group.logs, class_name](std::string_view config) {
+            return [logs, class_name, config = std::string{config}](
+                           config::LogLevel, std::string_view x) {
+                logs->log(
+                        "libsession-util:" + class_name + ":" + config + ": " + std::string{x} +
+                        "\n");
+            };
+        };
+        group.info->logger = logger("Info");
+        group.members->logger = logger("Members");
+        group.keys->logger = logger("Keys");
+
+        return group;
+    });
+}
+
+/** ==============================
+ *         COMBINED METHODS
+ * ============================== */
+
+void MetaGroupWrapper::configChanged() {
+    if (persist_)
+        persist_->notify();
+}
+
+bool MetaGroupWrapper::needsDumpGroup() {
+    return dump_pending_ || info_impl_.needsDumpConfig() || members_impl_.needsDumpConfig() ||
+           keys_.needs_dump();
+}
+
+ustring MetaGroupWrapper::dumpGroup() {
+    auto info_dump = info_impl_.dumpConfig();
+    auto keys_dump = keys_.dump();
+    auto members_dump = members_impl_.dumpConfig();
+    dump_pending_ = false;
+
+    // (the keys of a bt dict must be appended in order)
+    oxenc::bt_dict_producer combined;
+    combined.append("info", as_string_view(info_dump));
+    combined.append("keys", as_string_view(keys_dump));
+    combined.append("members", as_string_view(members_dump));
+    auto dumped = std::move(combined).str();
+    return ustring{reinterpret_cast<const unsigned char*>(dumped.data()), dumped.size()};
+}
+
+Napi::Value MetaGroupWrapper::needsPush(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return info_impl_.needsPushConfig() || members_impl_.needsPushConfig() ||
+               keys_.pending_config().has_value();
+    });
+}
+
+Napi::Value MetaGroupWrapper::needsDump(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return needsDumpGroup();
+    });
+}
+
+Napi::Value MetaGroupWrapper::push(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&] {
+        assertInfoLength(info, 0);
+        auto result = Napi::Object::New(env);
+        result["groupInfo"] = config_push(env, info_impl_);
+        result["groupMember"] = config_push(env, members_impl_);
+
+        // The keys have no seqno: their message is pending until it comes back through `merge`
+        if (auto pending = keys_.pending_config()) {
+            auto keys = Napi::Object::New(env);
+            keys["data"] = toJs(env, *pending);
+            keys["namespace"] = toJs(env, static_cast<uint16_t>(keys_.storage_namespace()));
+            result["groupKeys"] = keys;
+        } else {
+            result["groupKeys"] = env.Null();
+        }
+        return result;
+    });
+}
+
+Napi::Value MetaGroupWrapper::dump(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return dumpGroup();
+    });
+}
+
+void MetaGroupWrapper::confirmPushed(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        assertIsObject(info[0]);
+        auto obj = info[0].As<Napi::Object>();
+        config_confirm(info_impl_, obj.Get("groupInfo"), "MetaGroup.confirmPushed.groupInfo");
+        config_confirm(
+                members_impl_, obj.Get("groupMember"), "MetaGroup.confirmPushed.groupMember");
+    });
+}
+
+Napi::Value MetaGroupWrapper::merge(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&] {
+        assertInfoLength(info, 1);
+        assertIsObject(info[0]);
+        auto obj = info[0].As<Napi::Object>();
+
+        auto info_msgs = messages_arg(obj.Get("groupInfo"), "MetaGroup.merge.groupInfo");
+        auto member_msgs = messages_arg(obj.Get("groupMember"), "MetaGroup.merge.groupMember");
+        std::vector<std::tuple<std::string, ustring_view, int64_t>> key_msgs;
+        if (auto keys_val = obj.Get("groupKeys"); !keys_val.IsUndefined() && !keys_val.IsNull()) {
+            assertIsArray(keys_val);
+            auto arr = keys_val.As<Napi::Array>();
+            for (uint32_t i = 0; i < arr.Length(); i++) {
+                auto item = arr.Get(i);
+                assertIsObject(item);
+                auto msg = item.As<Napi::Object>();
+                key_msgs.emplace_back(
+                        toCppString(msg.Get("hash"), "MetaGroup.merge.groupKeys"),
+                        toCppBufferView(msg.Get("data"), "MetaGroup.merge.groupKeys"),
+                        toCppInteger(msg.Get("timestampMs"), "MetaGroup.merge.groupKeys", false));
+            }
+        }
+
+        // The keys go first, as the info and members messages may be encrypted with new ones.  A
+        // key message libsession rejects (or throws on) is left out of the result, like the info
+        // and members messages it fails to decrypt, and doesn't keep the others from merging.
+        std::vector<std::string> keys_merged;
+        {
+            // New keys change how the info and members are encrypted
+            std::optional<Mutation> info_change, members_change;
+            for (const auto& [hash, data, timestamp_ms] : key_msgs) {
+                try {
+                    if (!keys_.load_key_message(hash, data, timestamp_ms, info_, members_))
+                        continue;
+                } catch (const std::exception& e) {
+                    group_.logs->log(
+                            "libsession-util:MetaGroupWrapper:Keys: failed to load " + hash +
+                            ": " + e.what() + "\n");
+                    continue;
+                }
+                keys_merged.push_back(hash);
+                if (!info_change) {
+                    info_change.emplace(info_impl_, ChangeKind::merge);
+                    members_change.emplace(members_impl_, ChangeKind::merge);
+                }
+            }
+        }
+
+        auto result = Napi::Object::New(env);
+        result["groupKeys"] = toJs(env, keys_merged);
+        result["groupInfo"] = toJs(env, info_impl_.mergeConfig(info_msgs));
+        result["groupMember"] = toJs(env, members_impl_.mergeConfig(member_msgs));
+
+        // `needs_rekey()` may now be set: it means that several admins rekeyed concurrently, which
+        // one of them must resolve by rekeying again.  That is left to the app (see
+        // `keysNeedsRekey`), rather than having every admin merging these messages rekey.
+        return result;
+    });
+}
+
+Napi::Value MetaGroupWrapper::statusBlock(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&] {
+        assertInfoLength(info, 0);
+        auto result = Napi::Object::New(env);
+        result["groupInfo"] = info_impl_.statusBlock(info);
+        result["groupMember"] = members_impl_.statusBlock(info);
+        return result;
+    });
+}
+
+void MetaGroupWrapper::onChange(const Napi::CallbackInfo& info) {
+    // The listener is told which of the two changed by the `namespace` of its events
+    info_impl_.onChange(info);
+    members_impl_.onChange(info);
+}
+
+void MetaGroupWrapper::autoPersist(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        persist_.reset();
+        if (info[0].IsNull() || info[0].IsUndefined())
+            return;
+        assertIsObject(info[0]);
+        auto env = info.Env();
+
+        // The three configs are persisted together, as the single dump `dump` returns
+        persist_ = std::make_unique<PersistScheduler>(
+                env,
+                PersistScheduler::optionsFromJs(env, info[0].As<Napi::Object>()),
+                [this]() -> std::optional<ustring> {
+                    if (!needsDumpGroup())
+                        return std::nullopt;
+                    return dumpGroup();
+                },
+                [this] { dump_pending_ = true; });
+        if (needsDumpGroup())
+            persist_->notify();
+    });
+}
+
+Napi::Value MetaGroupWrapper::flushPersist(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        if (!persist_)
+            throw std::logic_error{"flushPersist: autoPersist is not enabled"};
+        return persist_->flush();
+    });
+}
+
+/** ==============================
+ *              INFO
+ * ============================== */
+
+Napi::Value MetaGroupWrapper::infoGet(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapResult(env, [&] {
+        assertInfoLength(info, 0);
+        auto obj = Napi::Object::New(env);
+        obj["name"] = toJs(env, info_.get_name());
+        obj["createdAtSeconds"] = toJs(env, info_.get_created());
+        std::optional<int64_t> expiry;
+        if (auto timer = info_.get_expiry_timer())
+            expiry = timer->count();
+        obj["expirySeconds"] = toJs(env, expiry);
+        obj["deleteBeforeSeconds"] = toJs(env, info_.get_delete_before());
+        obj["deleteAttachBeforeSeconds"] = toJs(env, info_.get_delete_attach_before());
+        obj["isDestroyed"] = toJs(env, info_.is_destroyed());
+        obj["profilePicture"] = object_from_profile_pic(env, info_.get_profile_pic());
+        return obj;
+    });
+}
+
+void MetaGroupWrapper::infoSet(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        assertIsObject(info[0]);
+        auto obj = info[0].As<Napi::Object>();
+
+        // Only the fields given are changed
+        Mutation mutation{info_impl_};
+        if (auto name = obj.Get("name"); !name.IsUndefined())
+            info_.set_name(maybeNonemptyString(name, "MetaGroup.infoSet.name").value_or(""));
+        if (auto created = obj.Get("createdAtSeconds"); !created.IsUndefined())
+            info_.set_created(toCppInteger(created, "MetaGroup.infoSet.createdAtSeconds"));
+        if (auto expiry = obj.Get("expirySeconds"); !expiry.IsUndefined())
+            info_.set_expiry_timer(std::chrono::seconds{
+                    toCppInteger(expiry, "MetaGroup.infoSet.expirySeconds")});
+        if (auto before = obj.Get("deleteBeforeSeconds"); !before.IsUndefined())
+            info_.set_delete_before(toCppInteger(before, "MetaGroup.infoSet.deleteBeforeSeconds"));
+        if (auto before = obj.Get("deleteAttachBeforeSeconds"); !before.IsUndefined())
+            info_.set_delete_attach_before(
+                    toCppInteger(before, "MetaGroup.infoSet.deleteAttachBeforeSeconds"));
+        if (auto pic = obj.Get("profilePicture"); !pic.IsUndefined())
+            info_.set_profile_pic(profile_pic_from_object(pic));
+    });
+}
+
+void MetaGroupWrapper::infoDestroy(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        Mutation mutation{info_impl_};
+        info_.destroy_group();
+    });
+}
+
+/** ==============================
+ *             MEMBERS
+ * ============================== */
+
+Napi::Value MetaGroupWrapper::memberGet(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] { return members_.get(getStringArgs<1>(info)); });
+}
+
+Napi::Value MetaGroupWrapper::memberGetAll(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    return wrapExceptions(env, [&] {
+        assertInfoLength(info, 0);
+
+        auto result = Napi::Array::New(env, members_.size());
+        size_t i = 0;
+        for (const auto& m : members_)
+            result[i++] = toJs(env, m);
+        return result;
+    });
+}
+
+void MetaGroupWrapper::membersAdd(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        assertIsArray(info[0]);
+        auto arr = info[0].As<Napi::Array>();
+
+        // Everything is parsed before anything is changed, so that a bad entry changes nothing
+        std::vector<member> added;
+        added.reserve(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            auto item = arr.Get(i);
+            assertIsObject(item);
+            auto obj = item.As<Napi::Object>();
+            auto& m = added.emplace_back(members_.get_or_construct(
+                    toCppString(obj.Get("pubkeyHex"), "MetaGroup.membersAdd.pubkeyHex")));
+            if (auto name = maybeNonemptyString(obj.Get("name"), "MetaGroup.membersAdd.name"))
+                m.set_name(std::move(*name));
+            if (auto pic = obj.Get("profilePicture"); !pic.IsUndefined())
+                m.profile_picture = profile_pic_from_object(pic);
+        }
+        Mutation mutation{members_impl_};
+        for (const auto& m : added)
+            members_.set(m);
+    });
+}
+
+void MetaGroupWrapper::membersSetInvited(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 2);
+        auto pubkeys = pubkeys_arg(info[0], "MetaGroup.membersSetInvited");
+        bool failed = toCppBoolean(info[1], "MetaGroup.membersSetInvited");
+        update_members(
+                members_impl_, members_, pubkeys, "membersSetInvited", [failed](member& m) {
+                    m.set_invited(failed);
+                });
+    });
+}
+
+void MetaGroupWrapper::membersSetAccepted(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        auto pubkeys = pubkeys_arg(info[0], "MetaGroup.membersSetAccepted");
+        update_members(members_impl_, members_, pubkeys, "membersSetAccepted", [](member& m) {
+            m.set_accepted();
+        });
+    });
+}
+
+void MetaGroupWrapper::membersSetPromoted(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 2);
+        auto pubkeys = pubkeys_arg(info[0], "MetaGroup.membersSetPromoted");
+        bool failed = toCppBoolean(info[1], "MetaGroup.membersSetPromoted");
+        update_members(
+                members_impl_, members_, pubkeys, "membersSetPromoted", [failed](member& m) {
+                    m.set_promoted(failed);
+                });
+    });
+}
+
+Napi::Value MetaGroupWrapper::membersRemove(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 1);
+        auto pubkeys = pubkeys_arg(info[0], "MetaGroup.membersRemove");
+        Mutation members_change{members_impl_};
+        size_t erased = 0;
+        for (const auto& pubkey : pubkeys)
+            if (members_.erase(pubkey))
+                erased++;
+
+        // The removed members must not be able to read what comes next; rekeying once for the
+        // whole batch is what makes removing many members at once cheap.
+        if (erased && keys_.admin()) {
+            Mutation info_change{info_impl_};
+            keys_.rekey(info_, members_);
+        }
+        return erased;
+    });
+}
+
+/** ==============================
+ *              KEYS
+ * ============================== */
+
+Napi::Value MetaGroupWrapper::keysAdmin(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return keys_.admin();
+    });
+}
+
+Napi::Value MetaGroupWrapper::keysNeedsRekey(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        return keys_.needs_rekey();
+    });
+}
+
+void MetaGroupWrapper::keysRekey(const Napi::CallbackInfo& info) {
+    wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        if (!keys_.admin())
+            throw std::logic_error{"keysRekey: only admins can rekey the group"};
+        Mutation info_change{info_impl_}, members_change{members_impl_};
+        keys_.rekey(info_, members_);
+    });
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <napi.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base_config.hpp"
+#include "log_queue.hpp"
+#include "meta/meta_base_wrapper.hpp"
+#include "persist_scheduler.hpp"
+#include "session/config/groups/info.hpp"
+#include "session/config/groups/keys.hpp"
+#include "session/config/groups/members.hpp"
+
+namespace session::nodeapi {
+
+/// The Info or Members config of a group, with what a standalone wrapper keeps on top of its config
+/// (push cache, seen hashes, status block, `onChange` listener...).  This is not a JS object of its
+/// own: MetaGroupWrapper exposes the two of them together.  As the group's Keys hold references to
+/// these configs, they can't be rebuilt from a dump: they don't support transactions and
+/// restoring snapshots.
+class GroupConfigImpl : public ConfigBaseImpl {
+  public:
+    // `changed` is called whenever the `onChange` listener would be.
+    GroupConfigImpl(
+            std::shared_ptr<config::ConfigBase> conf,
+            std::shared_ptr<LogQueue> logs,
+            napi_env env,
+            std::function<void()> changed) :
+            ConfigBaseImpl{Constructed{std::move(conf), nullptr, std::move(logs), env, 0}},
+            changed_{std::move(changed)} {}
+
+    ~GroupConfigImpl() override = default;
+
+    using ConfigBaseImpl::Mutation;
+
+  protected:
+    void changeNotified() override {
+        if (changed_)
+            changed_();
+    }
+
+  private:
+    std::function<void()> changed_;
+};
+
+/// Wraps the Info, Members and Keys configs of a closed group together, as one object: they are
+/// merged, pushed, confirmed and dumped in a single call each (spanning the three namespaces), and
+/// the member operations take arrays so that large groups don't need one call per member.
+class MetaGroupWrapper : public MetaBaseWrapper, public Napi::ObjectWrap<MetaGroupWrapper> {
+  public:
+    static void Init(Napi::Env env, Napi::Object exports);
+
+    explicit MetaGroupWrapper(const Napi::CallbackInfo& info);
+
+    // Returns the group wrapper `val` is, or nullptr if it is anything else.
+    static MetaGroupWrapper* maybeUnwrap(Napi::Value val);
+
+    // The Info and Members configs, for the static functions operating on several wrappers
+    std::vector<ConfigBaseImpl*> configs() { return {&info_impl_, &members_impl_}; }
+
+  private:
+    // The three configs of a closed group.  They go together: the Keys hold the encryption keys of
+    // the Info and Members (and need them to rekey).
+    struct MetaGroup {
+        std::shared_ptr<config::groups::Info> info;
+        std::shared_ptr<config::groups::Members> members;
+        std::shared_ptr<config::groups::Keys> keys;
+        std::shared_ptr<LogQueue> logs;
+    };
+
+    // Constructs the configs of a group from the constructor argument of a group wrapper:
+    // `{userEd25519Secretkey, groupEd25519Pubkey, groupEd25519Secretkey, metaDumped}`, the last
+    // two being optional (only admins have the group's secret key).  `metaDumped` is the combined
+    // dump of the three configs, as a bt-encoded dict of their own dumps.
+    static MetaGroup constructGroupWrapper(
+            const Napi::CallbackInfo& info, const std::string& class_name);
+
+    MetaGroup group_;
+    config::groups::Info& info_{*group_.info};
+    config::groups::Members& members_{*group_.members};
+    config::groups::Keys& keys_{*group_.keys};
+
+    // All the changes to the Info and Members go through these, so that they are tracked like
+    // those of any other config
+    GroupConfigImpl info_impl_;
+    GroupConfigImpl members_impl_;
+
+    // Set by `autoPersist`
+    std::unique_ptr<PersistScheduler> persist_;
+    // Set when a dump made by `autoPersist` could not be written
+    bool dump_pending_ = false;
+
+    // Called whenever the `onChange` listener of the Info or Members would be
+    void configChanged();
+    bool needsDumpGroup();
+    ustring dumpGroup();
+
+    // Combined operations over the three configs
+    Napi::Value needsPush(const Napi::CallbackInfo& info);
+    Napi::Value needsDump(const Napi::CallbackInfo& info);
+    Napi::Value push(const Napi::CallbackInfo& info);
+    Napi::Value dump(const Napi::CallbackInfo& info);
+    void confirmPushed(const Napi::CallbackInfo& info);
+    Napi::Value merge(const Napi::CallbackInfo& info);
+    Napi::Value statusBlock(const Napi::CallbackInfo& info);
+    void onChange(const Napi::CallbackInfo& info);
+    void autoPersist(const Napi::CallbackInfo& info);
+    Napi::Value flushPersist(const Napi::CallbackInfo& info);
+
+    // Info related methods
+    Napi::Value infoGet(const Napi::CallbackInfo& info);
+    void infoSet(const Napi::CallbackInfo& info);
+    void infoDestroy(const Napi::CallbackInfo& info);
+
+    // Members related methods
+    Napi::Value memberGet(const Napi::CallbackInfo& info);
+    Napi::Value memberGetAll(const Napi::CallbackInfo& info);
+    void membersAdd(const Napi::CallbackInfo& info);
+    void membersSetInvited(const Napi::CallbackInfo& info);
+    void membersSetAccepted(const Napi::CallbackInfo& info);
+    void membersSetPromoted(const Napi::CallbackInfo& info);
+    Napi::Value membersRemove(const Napi::CallbackInfo& info);
+
+    // Keys related methods
+    Napi::Value keysAdmin(const Napi::CallbackInfo& info);
+    Napi::Value keysNeedsRekey(const Napi::CallbackInfo& info);
+    void keysRekey(const Napi::CallbackInfo& info);
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,84 @@
+#include "parallel.hpp"
+
+namespace session::nodeapi::detail {
+
+namespace {
+    thread_local bool is_pool_thread = false;
+}
+
+ThreadPool& ThreadPool::instance() {
+    static auto* pool =
+            new ThreadPool{std::max(1u, std::thread::hardware_concurrency()) - size_t{1}};
+    return *pool;
+}
+
+bool ThreadPool::on_pool_thread() {
+    return is_pool_thread;
+}
+
+ThreadPool::ThreadPool(size_t n_threads) {
+    threads_.reserve(n_threads);
+    for (size_t i = 0; i < n_threads; i++)
+        threads_.emplace_back([this] { run(); });
+}
+
+void ThreadPool::post(std::function<void()> task, size_t count) {
+    {
+        std::lock_guard lock{mutex_};
+        for (size_t i = 0; i < count; i++)
+            tasks_.push_back(task);
+    }
+    if (count == 1)
+        cv_.notify_one();
+    else
+        cv_.notify_all();
+}
+
+void ThreadPool::run() {
+    is_pool_thread = true;
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock{mutex_};
+            cv_.wait(lock, [this] { return !tasks_.empty(); });
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void ParallelFor::work() {
+    for (size_t i; !failed && (i = next++) < n;) {
+        try {
+            f(i);
+        } catch (...) {
+            std::lock_guard lock{mutex};
+            if (!error)
+                error = std::current_exception();
+            failed = true;
+        }
+    }
+}
+
+void ParallelFor::help() {
+    {
+        std::lock_guard lock{mutex};
+        if (failed || next >= n)
+            return;
+        running++;
+    }
+    work();
+    {
+        std::lock_guard lock{mutex};
+        running--;
+    }
+    cv.notify_all();
+}
+
+void ParallelFor::wait() {
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [this] { return running == 0; });
+}
+
+}  // namespace session::nodeapi::detail
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace session::nodeapi {
+
+namespace detail {
+
+    /// The threads `parallel_for` spreads its work over.  They are started on first use and live
+    /// until the process exits, so that a call only pays for waking them up.
+    class ThreadPool {
+      public:
+        // The process-wide pool, of `std::thread::hardware_concurrency() - 1` threads (the thread
+        // calling `parallel_for` being the last one).  It is never destroyed: joining its threads
+        // from a static destructor could hang the process on exit.
+        static ThreadPool& instance();
+
+        // Whether the calling thread is one of the pool's
+        static bool on_pool_thread();
+
+        size_t size() const { return threads_.size(); }
+
+        // Queues `count` calls of `task`, each of which will run on one of the pool threads.
+        void post(std::function<void()> task, size_t count);
+
+      private:
+        explicit ThreadPool(size_t n_threads);
+
+        void run();
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::function<void()>> tasks_;
+        std::vector<std::thread> threads_;
+    };
+
+    /// The items of one `parallel_for` call, shared between the calling thread and the pool threads
+    /// helping it.  A pool thread may only get to its task once the calling thread is done with all
+    /// the items (and gone): `f`, which lives on the caller's stack, is only called by threads
+    /// which registered as `running` while there were items left, and the caller waits for those.
+    struct ParallelFor {
+        size_t n;
+        std::function<void(size_t)> f;
+
+        std::atomic<size_t> next{0};
+        std::atomic<bool> failed{false};
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t running = 0;
+        std::exception_ptr error;
+
+        ParallelFor(size_t n, std::function<void(size_t)> f) : n{n}, f{std::move(f)} {}
+
+        // Processes items until there are none left
+        void work();
+
+        // Called on a pool thread
+        void help();
+
+        // Waits for the pool threads which are still processing items
+        void wait();
+    };
+
+}  // namespace detail
+
+// Calls `f(i)` for each i in [0, n), spread over the threads of a pool of up to
+// `std::thread::hardware_concurrency()` threads (the calling thread being one of them), and returns
+// once they are all done.  Each thread gets at least `min_per_thread` items, so that small batches
+// don't pay for waking up threads.  A `parallel_for` called from within `f` runs on its calling
+// thread only, as the pool threads may all be busy with the outer one.
+//
+// `f` must be safe to call concurrently, and must not touch any JS value.  If it throws, the
+// remaining items are skipped and the first exception is rethrown on the calling thread.
+template <typename F>
+void parallel_for(size_t n, F&& f, size_t min_per_thread = 1) {
+    if (n == 0)
+        return;
+
+    min_per_thread = std::max<size_t>(min_per_thread, 1);
+    size_t helpers = 0;
+    if (!detail::ThreadPool::on_pool_thread()) {
+        auto wanted = (n + min_per_thread - 1) / min_per_thread - 1;
+        helpers = std::min(detail::ThreadPool::instance().size(), wanted);
+    }
+
+    auto job = std::make_shared<detail::ParallelFor>(n, [&f](size_t i) { f(i); });
+    if (helpers)
+        detail::ThreadPool::instance().post([job] { job->help(); }, helpers);
+    job->work();
+    job->wait();
+
+    if (job->error)
+        std::rethrow_exception(job->error);
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,280 @@
+#include "persist_scheduler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "utilities.hpp"
+
+namespace session::nodeapi {
+
+namespace {
+
+    // Writes `data` to the file at `path` (created or truncated), and syncs it to disk.
+    bool write_file(const std::string& path, const ustring& data) {
+#ifdef _WIN32
+        FILE* file = _wfopen(std::filesystem::u8path(path).c_str(), L"wb");
+#else
+        FILE* file = std::fopen(path.c_str(), "wb");
+#endif
+        if (!file)
+            return false;
+        bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size() &&
+                  std::fflush(file) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(file)) == 0;
+#else
+        ok = ok && fsync(fileno(file)) == 0;
+#endif
+        return std::fclose(file) == 0 && ok;
+    }
+
+    // Atomically replaces the file at `to` with the one at `from`.
+    bool replace_file(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        return MoveFileExW(
+                       std::filesystem::u8path(from).c_str(),
+                       std::filesystem::u8path(to).c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+
+    // Syncs the directory holding `path`, so that a rename into it survives a crash.  Windows has
+    // no such thing: MOVEFILE_WRITE_THROUGH covers it.
+    bool sync_directory([[maybe_unused]] const std::string& path) {
+#ifdef _WIN32
+        return true;
+#else
+        auto dir = std::filesystem::path{path}.parent_path();
+        int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0)
+            return false;
+        bool ok = fsync(fd) == 0;
+        close(fd);
+        return ok;
+#endif
+    }
+
+}  // namespace
+
+struct PersistScheduler::State {
+    Options options;
+    Metrics metrics;
+
+    // The scheduler's `failed`, and whether the scheduler is still there to call it (JS thread)
+    std::function<void()> failed;
+    bool alive = true;
+    // Writes failed in a row, for the retry backoff (JS thread)
+    unsigned failures = 0;
+
+    // Dumps are numbered so that a write finishing late never replaces a newer one
+    uint64_t generation = 0;
+    std::mutex file_mutex;
+    uint64_t written_generation = 0;
+
+    // Writes `data` to the sink file, returning false on failure.  Safe to call from any thread.
+    bool write(uint64_t gen, const ustring& data) {
+        auto tmp = options.path + ".tmp" + std::to_string(gen);
+        if (!write_file(tmp, data)) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+
+        std::lock_guard lock{file_mutex};
+        if (gen < written_generation) {
+            std::remove(tmp.c_str());
+            return true;
+        }
+        if (!replace_file(tmp, options.path)) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        written_generation = gen;
+        return sync_directory(options.path);
+    }
+
+    // Accounts for the outcome of writing dump `gen`.  JS thread only.
+    void written(uint64_t gen, size_t size, bool ok) {
+        if (ok) {
+            metrics.bytes_written += size;
+            if (gen == generation)
+                failures = 0;
+            return;
+        }
+        metrics.write_errors++;
+        // A later dump holds everything this one did
+        if (alive && gen == generation)
+            failed();
+    }
+};
+
+namespace {
+
+    struct WriteJob {
+        uv_work_t req;
+        std::shared_ptr<PersistScheduler::State> state;
+        uint64_t gen;
+        ustring data;
+        bool ok = false;
+    };
+
+}  // namespace
+
+PersistScheduler::PersistScheduler(
+        Napi::Env env,
+        Options options,
+        std::function<std::optional<ustring>()> dump,
+        std::function<void()> failed) :
+        state_{std::make_shared<State>()}, env_{env}, dump_{std::move(dump)} {
+    state_->options = std::move(options);
+    state_->failed = [this, failed = std::move(failed)] {
+        failed();
+        retry();
+    };
+    if (napi_get_uv_event_loop(env, &loop_) != napi_ok)
+        throw std::runtime_error{"PersistScheduler: failed to get the event loop"};
+
+    timer_ = new uv_timer_t;
+    uv_timer_init(loop_, timer_);
+    timer_->data = this;
+    // A pending dump must not keep the process alive: use `flush()` before exiting
+    uv_unref(reinterpret_cast<uv_handle_t*>(timer_));
+}
+
+PersistScheduler::Options PersistScheduler::optionsFromJs(Napi::Env env, Napi::Object obj) {
+    Options options;
+    if (auto debounce = obj.Get("debounceMs"); !debounce.IsUndefined())
+        options.debounce_ms = toCppInteger(debounce, "autoPersist.debounceMs", false);
+    if (auto max_latency = obj.Get("maxLatencyMs"); !max_latency.IsUndefined())
+        options.max_latency_ms = toCppInteger(max_latency, "autoPersist.maxLatencyMs", false);
+
+    auto path = obj.Get("path");
+    auto sink = obj.Get("sink");
+    if (path.IsUndefined() == sink.IsUndefined())
+        throw std::invalid_argument{"autoPersist: exactly one of path and sink must be given"};
+    if (!path.IsUndefined()) {
+        options.path = toCppString(path, "autoPersist.path");
+    } else {
+        if (!sink.IsFunction())
+            throw std::invalid_argument{"autoPersist: sink must be a function"};
+        options.sink = Napi::ThreadSafeFunction::New(
+                env, sink.As<Napi::Function>(), "libsession-util autoPersist", 0, 1);
+        options.sink->Unref(env);
+    }
+    return options;
+}
+
+PersistScheduler::~PersistScheduler() {
+    state_->alive = false;
+    uv_timer_stop(timer_);
+    uv_close(reinterpret_cast<uv_handle_t*>(timer_), [](uv_handle_t* handle) {
+        delete reinterpret_cast<uv_timer_t*>(handle);
+    });
+    if (state_->options.sink)
+        state_->options.sink->Release();
+}
+
+void PersistScheduler::notify() {
+    uint64_t now = uv_now(loop_);
+    if (pending_mutations_++ == 0)
+        pending_since_ = now;
+
+    uint64_t deadline = pending_since_ + state_->options.max_latency_ms;
+    uint64_t delay = std::min(
+            state_->options.debounce_ms, deadline > now ? deadline - now : uint64_t{0});
+    uv_timer_start(timer_, &PersistScheduler::on_timer, delay, 0);
+}
+
+bool PersistScheduler::flush() {
+    uv_timer_stop(timer_);
+    return persist(true);
+}
+
+const PersistScheduler::Metrics& PersistScheduler::metrics() const {
+    return state_->metrics;
+}
+
+void PersistScheduler::on_timer(uv_timer_t* timer) {
+    auto* self = static_cast<PersistScheduler*>(timer->data);
+    // Called straight from the event loop: there is neither a handle scope nor anything to throw to
+    Napi::HandleScope scope{self->env_};
+    try {
+        self->persist(false);
+    } catch (...) {
+        // The dump may have been taken already: make sure it is retried
+        self->state_->metrics.write_errors++;
+        self->state_->failed();
+    }
+}
+
+void PersistScheduler::retry() {
+    uint64_t delay = std::max(state_->options.debounce_ms, uint64_t{1});
+    for (unsigned i = 0; i < state_->failures && delay < MAX_RETRY_DELAY_MS; i++)
+        delay *= 2;
+    state_->failures++;
+    uv_timer_start(timer_, &PersistScheduler::on_timer, std::min(delay, MAX_RETRY_DELAY_MS), 0);
+}
+
+bool PersistScheduler::persist(bool sync) {
+    auto mutations = std::exchange(pending_mutations_, 0);
+
+    auto dumped = dump_();
+    if (!dumped)
+        return false;
+
+    auto& metrics = state_->metrics;
+    metrics.dumps++;
+    if (mutations > 1)
+        metrics.coalesced_mutations += mutations - 1;
+
+    if (auto& sink = state_->options.sink) {
+        metrics.bytes_written += dumped->size();
+        sink->NonBlockingCall([data = std::move(*dumped)](Napi::Env env, Napi::Function callback) {
+            callback.Call({toJs(env, data)});
+        });
+        return true;
+    }
+
+    uint64_t gen = ++state_->generation;
+    if (sync) {
+        state_->written(gen, dumped->size(), state_->write(gen, *dumped));
+        return true;
+    }
+
+    auto* job = new WriteJob{{}, state_, gen, std::move(*dumped)};
+    job->req.data = job;
+    int err = uv_queue_work(
+            loop_,
+            &job->req,
+            [](uv_work_t* req) {
+                auto* job = static_cast<WriteJob*>(req->data);
+                job->ok = job->state->write(job->gen, job->data);
+            },
+            [](uv_work_t* req, int) {
+                std::unique_ptr<WriteJob> job{static_cast<WriteJob*>(req->data)};
+                try {
+                    job->state->written(job->gen, job->data.size(), job->ok);
+                } catch (...) {
+                    // Nothing to report it to, from the event loop
+                }
+            });
+    if (err != 0) {
+        delete job;
+        state_->written(gen, 0, false);
+    }
+    return true;
+}
+
+}  // namespace session::nodeapi
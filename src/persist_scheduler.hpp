@@ -0,0 +1,92 @@
+#pragma once
+
+#include <napi.h>
+#include <uv.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "session/types.hpp"
+
+namespace session::nodeapi {
+
+/// Dumps a config some time after it changed, and hands the dump to a sink: either a file (written
+/// and synced to disk on the libuv thread pool, replacing the previous one atomically) or a JS
+/// callback.
+///
+/// The delay is restarted by every change (`debounce_ms`) but never exceeds `max_latency_ms`
+/// since the first change not persisted yet.  The dump itself happens on the JS thread, as the
+/// config must not be accessed concurrently; only the file write is done on another thread.  A
+/// write which failed is retried, with a delay starting at `debounce_ms` and doubling after each
+/// failure in a row (up to `MAX_RETRY_DELAY_MS`).
+class PersistScheduler {
+  public:
+    struct Options {
+        uint64_t debounce_ms = 1000;
+        uint64_t max_latency_ms = 10'000;
+        // Exactly one of these is set
+        std::string path;
+        std::optional<Napi::ThreadSafeFunction> sink;
+    };
+
+    struct Metrics {
+        uint64_t dumps = 0;
+        uint64_t bytes_written = 0;
+        // Changes which did not need a dump of their own, as a later one covered them
+        uint64_t coalesced_mutations = 0;
+        // Dumps which failed, or could not be written
+        uint64_t write_errors = 0;
+    };
+
+    // Shared with the file writes in flight, which can outlive the scheduler
+    struct State;
+
+    static constexpr uint64_t MAX_RETRY_DELAY_MS = 60'000;
+
+    // Reads the options of `autoPersist`: `{debounceMs?, maxLatencyMs?}` and either `path` or
+    // `sink`.
+    static Options optionsFromJs(Napi::Env env, Napi::Object obj);
+
+    // `dump` returns a dump of the config if it needs one, nullopt otherwise.  `failed` is called
+    // when a dump could not be written (and no later dump replaces it), so that the config is
+    // marked as needing a dump again; the retry is then scheduled.  Both are called on the JS
+    // thread only.
+    PersistScheduler(
+            Napi::Env env,
+            Options options,
+            std::function<std::optional<ustring>()> dump,
+            std::function<void()> failed);
+    ~PersistScheduler();
+
+    PersistScheduler(const PersistScheduler&) = delete;
+    PersistScheduler& operator=(const PersistScheduler&) = delete;
+
+    // To be called after every change to the config.
+    void notify();
+
+    // Dumps (if needed) right away rather than when the timer fires; file sinks are written before
+    // returning.  Returns true if a dump was made.
+    bool flush();
+
+    const Metrics& metrics() const;
+
+  private:
+    std::shared_ptr<State> state_;
+    napi_env env_;
+    uv_loop_t* loop_;
+    uv_timer_t* timer_;
+    std::function<std::optional<ustring>()> dump_;
+
+    uint64_t pending_since_ = 0;
+    uint64_t pending_mutations_ = 0;
+
+    bool persist(bool sync);
+    // Arms the timer for another attempt after a failed one, backing off.
+    void retry();
+    static void on_timer(uv_timer_t* timer);
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "session/config/base.hpp"
+#include "session/types.hpp"
+
+namespace session::nodeapi {
+
+/// The last result of a config's push(), returned again by further pushes until the config
+/// changes: libsession re-serializes, compresses and encrypts the config on every push(), even
+/// though it produces the same output until the config changes.  Also holds the last push size
+/// estimate, for the same reason.
+///
+/// The owner must call `invalidate()` before anything changes the config.
+class PushCache {
+  public:
+    using Pushed = std::tuple<config::seqno_t, ustring, std::vector<std::string>>;
+
+    // Returns the cached push() result, or nullptr if there is none.
+    const Pushed* get() {
+        if (!pushed_)
+            return nullptr;
+        hits_++;
+        return &*pushed_;
+    }
+
+    const Pushed& set(Pushed pushed) { return pushed_.emplace(std::move(pushed)); }
+
+    bool has() const { return pushed_.has_value(); }
+
+    // The size of the cached push() data, if there is one, else the cached estimate, if any.
+    std::optional<size_t> size() const {
+        if (pushed_)
+            return std::get<1>(*pushed_).size();
+        return estimate_;
+    }
+
+    void setEstimate(size_t bytes) { estimate_ = bytes; }
+
+    void invalidate() {
+        pushed_.reset();
+        estimate_.reset();
+    }
+
+    // How many pushes were answered from the cache
+    size_t hits() const { return hits_; }
+
+    // What the cached result takes in memory
+    size_t memoryUsage() const {
+        if (!pushed_)
+            return 0;
+        const auto& [seqno, data, hashes] = *pushed_;
+        size_t bytes = data.size();
+        for (const auto& hash : hashes)
+            bytes += sizeof(hash) + hash.size();
+        return bytes;
+    }
+
+  private:
+    std::optional<Pushed> pushed_;
+    std::optional<size_t> estimate_;
+    size_t hits_ = 0;
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <napi.h>
+
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "utilities.hpp"
+
+namespace session::nodeapi {
+
+// Native value of a record field, as seen by query filters.  `monostate` is what a JS `null`
+// compares equal to (e.g. an unset contact name).
+using FieldValue = std::variant<std::monostate, bool, int64_t, std::string>;
+
+// Describes one property of the JS object produced for a `Record`.  The getters build their objects
+// from the same fields as query projections do (see `object_from_fields`), so that the two always
+// agree:
+// - `get` extracts the native value used when evaluating filters; nullptr if the field cannot be
+//   filtered on (e.g. buffers or nested objects).
+// - `js` converts the field to JS when it is projected; if nullptr then the `get` value is
+//   converted instead.
+template <typename Record>
+struct QueryField {
+    std::string_view name;
+    FieldValue (*get)(const Record&) = nullptr;
+    Napi::Value (*js)(const Napi::Env&, const Record&) = nullptr;
+};
+
+template <typename Record>
+using QueryFields = std::vector<QueryField<Record>>;
+
+// Field value for strings that are exposed to JS as null when empty (see `maybe_string`).
+inline FieldValue maybe_field(std::string_view val) {
+    if (val.empty())
+        return std::monostate{};
+    return std::string{val};
+}
+
+namespace detail {
+
+    enum class QueryOp { eq, ne, gt, gte, lt, lte };
+
+    template <typename Record>
+    struct Predicate {
+        const QueryField<Record>* field;
+        QueryOp op;
+        FieldValue operand;
+
+        bool operator()(const Record& r) const {
+            auto value = field->get(r);
+            switch (op) {
+                case QueryOp::eq: return value == operand;
+                case QueryOp::ne: return value != operand;
+                default: break;
+            }
+            // Ordered comparisons only make sense between values of the same type (and never
+            // match null)
+            if (value.index() != operand.index() || value.index() == 0)
+                return false;
+            switch (op) {
+                case QueryOp::gt: return value > operand;
+                case QueryOp::gte: return value >= operand;
+                case QueryOp::lt: return value < operand;
+                case QueryOp::lte: return value <= operand;
+                default: return false;
+            }
+        }
+    };
+
+    inline FieldValue toFieldValue(Napi::Value x, const std::string& identifier) {
+        if (x.IsNull() || x.IsUndefined())
+            return std::monostate{};
+        if (x.IsBoolean())
+            return x.As<Napi::Boolean>().Value();
+        if (x.IsNumber()) {
+            // All the numeric fields are integers: rather than truncating a fractional number (and
+            // so matching values it is not equal to), it is rejected.
+            auto d = x.As<Napi::Number>().DoubleValue();
+            if (!std::isfinite(d) || std::trunc(d) != d || std::abs(d) > 9007199254740991.0)
+                throw std::invalid_argument{identifier + ": filter numbers must be safe integers"};
+            return static_cast<int64_t>(d);
+        }
+        if (x.IsString())
+            return x.As<Napi::String>().Utf8Value();
+        throw std::invalid_argument{
+                identifier + ": filter values must be a boolean, number, string or null"};
+    }
+
+    inline QueryOp toQueryOp(std::string_view op, const std::string& identifier) {
+        if (op == "eq")
+            return QueryOp::eq;
+        if (op == "ne")
+            return QueryOp::ne;
+        if (op == "gt")
+            return QueryOp::gt;
+        if (op == "gte")
+            return QueryOp::gte;
+        if (op == "lt")
+            return QueryOp::lt;
+        if (op == "lte")
+            return QueryOp::lte;
+        throw std::invalid_argument{
+                identifier + ": unknown filter operator '" + std::string{op} + "'"};
+    }
+
+    template <typename Record>
+    const QueryField<Record>& findField(
+            const QueryFields<Record>& fields,
+            std::string_view name,
+            const std::string& identifier) {
+        for (const auto& f : fields)
+            if (f.name == name)
+                return f;
+        throw std::invalid_argument{identifier + ": unknown field '" + std::string{name} + "'"};
+    }
+
+    // Parses a filter object such as `{approved: true, priority: {gt: 0}}`: each key is a field
+    // name, each value either a literal (equality) or an object of `{op: value}` where op is one of
+    // eq/ne/gt/gte/lt/lte.  All the predicates must match.
+    template <typename Record>
+    std::vector<Predicate<Record>> parseFilter(
+            Napi::Value filter, const QueryFields<Record>& fields, const std::string& identifier) {
+        std::vector<Predicate<Record>> predicates;
+        if (filter.IsNull() || filter.IsUndefined())
+            return predicates;
+        assertIsObject(filter);
+
+        auto obj = filter.As<Napi::Object>();
+        auto keys = obj.GetPropertyNames();
+        for (uint32_t i = 0; i < keys.Length(); i++) {
+            auto name = toCppString(keys.Get(i), identifier);
+            const auto& field = findField(fields, name, identifier);
+            if (!field.get)
+                throw std::invalid_argument{identifier + ": cannot filter on field '" + name + "'"};
+
+            auto condition = obj.Get(name);
+            if (condition.IsObject() && !condition.IsNull()) {
+                auto ops = condition.As<Napi::Object>();
+                auto op_names = ops.GetPropertyNames();
+                for (uint32_t j = 0; j < op_names.Length(); j++) {
+                    auto op = toCppString(op_names.Get(j), identifier);
+                    predicates.push_back(
+                            {&field,
+                             toQueryOp(op, identifier),
+                             toFieldValue(ops.Get(op), identifier)});
+                }
+            } else {
+                predicates.push_back({&field, QueryOp::eq, toFieldValue(condition, identifier)});
+            }
+        }
+        return predicates;
+    }
+
+    template <typename Record>
+    std::vector<const QueryField<Record>*> parseProjection(
+            Napi::Value projection,
+            const QueryFields<Record>& fields,
+            const std::string& identifier) {
+        std::vector<const QueryField<Record>*> projected;
+        if (projection.IsNull() || projection.IsUndefined()) {
+            for (const auto& f : fields)
+                projected.push_back(&f);
+            return projected;
+        }
+        assertIsArray(projection);
+        auto arr = projection.As<Napi::Array>();
+        for (uint32_t i = 0; i < arr.Length(); i++)
+            projected.push_back(
+                    &findField(fields, toCppString(arr.Get(i), identifier), identifier));
+        return projected;
+    }
+
+    inline Napi::Value fieldValueToJs(const Napi::Env& env, const FieldValue& value) {
+        return std::visit(
+                [&](const auto& v) -> Napi::Value {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::monostate>)
+                        return env.Null();
+                    else
+                        return toJs(env, v);
+                },
+                value);
+    }
+
+    template <typename Record>
+    Napi::Value fieldToJs(
+            const Napi::Env& env, const QueryField<Record>& field, const Record& record) {
+        if (field.js)
+            return field.js(env, record);
+        return fieldValueToJs(env, field.get(record));
+    }
+
+}  // namespace detail
+
+// Returns the JS object for `record`, made of all of its `fields`.  This is what toJs_impl of the
+// queryable records returns.
+template <typename Record>
+Napi::Object object_from_fields(
+        const Napi::Env& env, const QueryFields<Record>& fields, const Record& record) {
+    auto obj = Napi::Object::New(env);
+    for (const auto& field : fields)
+        obj[field.name.data()] = detail::fieldToJs(env, field, record);
+    return obj;
+}
+
+// Helper for the various "query" functions: takes a filter object (or null) and a list of field
+// names (or null for all fields) as arguments, evaluates the filter natively on each record of
+// [it...end) and returns an array of objects containing only the requested fields of the matching
+// records.  Throws a Napi::Error on invalid arguments.
+template <typename Record, typename It, typename EndIt>
+Napi::Array query_impl(
+        const Napi::CallbackInfo& info,
+        const QueryFields<Record>& fields,
+        It it,
+        EndIt end,
+        const std::string& identifier) {
+    auto env = info.Env();
+    return wrapExceptions(env, [&] {
+        assertInfoLength(info, 2);
+        auto predicates = detail::parseFilter(info[0], fields, identifier);
+        auto projected = detail::parseProjection(info[1], fields, identifier);
+
+        auto result = Napi::Array::New(env);
+        uint32_t i = 0;
+        for (; it != end; it++) {
+            const Record& record = *it;
+            bool matches = true;
+            for (const auto& pred : predicates)
+                if (!pred(record)) {
+                    matches = false;
+                    break;
+                }
+            if (!matches)
+                continue;
+
+            auto obj = Napi::Object::New(env);
+            for (const auto* field : projected)
+                obj[field->name.data()] = detail::fieldToJs(env, *field, record);
+            result[i++] = obj;
+        }
+        return result;
+    });
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,37 @@
+#include "readonly_registry.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace session::nodeapi {
+
+namespace {
+
+    std::mutex registry_mutex;
+    uint64_t next_handle = 1;
+    std::unordered_map<uint64_t, std::weak_ptr<const ReadOnlyRegistry::Data>> registry;
+
+}  // namespace
+
+uint64_t ReadOnlyRegistry::add(const std::shared_ptr<const Data>& data) {
+    std::lock_guard lock{registry_mutex};
+    // Forget the snapshots nobody reads anymore, so that the registry only grows with live ones
+    for (auto it = registry.begin(); it != registry.end();)
+        it = it->second.expired() ? registry.erase(it) : std::next(it);
+    auto handle = next_handle++;
+    registry.emplace(handle, data);
+    return handle;
+}
+
+std::shared_ptr<const ReadOnlyRegistry::Data> ReadOnlyRegistry::find(uint64_t handle) {
+    std::lock_guard lock{registry_mutex};
+    auto it = registry.find(handle);
+    auto data = it == registry.end() ? nullptr : it->second.lock();
+    if (!data)
+        throw std::invalid_argument{
+                "Unknown read-only snapshot " + std::to_string(handle) +
+                " (every object reading it was garbage collected, or it never existed)"};
+    return data;
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <napi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "utilities.hpp"
+
+namespace session::nodeapi {
+
+/// Process-wide registry of the read-only snapshots exported by config wrappers (see e.g.
+/// `ContactsConfigWrapper::exportReadOnly`).  Every worker_thread has its own JS environment (and
+/// instance of each wrapper class), but they all share this registry, so the numeric handle of a
+/// snapshot can be posted to a worker which then opens it without any copy or parsing.
+///
+/// The registry does not own the snapshots: they live as long as the JS objects reading them (see
+/// ReadOnlyWrapper).  The snapshots are immutable, and so safe to read from any number of threads
+/// at once.
+class ReadOnlyRegistry {
+  public:
+    struct Data {
+        virtual ~Data() = default;
+    };
+
+    // Adds a snapshot, returning its handle.
+    static uint64_t add(const std::shared_ptr<const Data>& data);
+
+    // Returns the snapshot with the given handle.  Throws std::invalid_argument if there is none
+    // (or every object reading it was garbage collected), or if it is not a `T`.
+    template <typename T>
+    static std::shared_ptr<const T> get(uint64_t handle) {
+        if (auto t = std::dynamic_pointer_cast<const T>(find(handle)))
+            return t;
+        throw std::invalid_argument{
+                "Read-only snapshot " + std::to_string(handle) + " is not of the requested type"};
+    }
+
+  private:
+    static std::shared_ptr<const Data> find(uint64_t handle);
+};
+
+// Returns the records of [it, end), which must be sorted by `key` (as libsession's are: its
+// collections are ordered maps); they are only sorted here otherwise.
+template <typename Record, typename It, typename EndIt, typename Key>
+std::vector<Record> copy_sorted(It it, EndIt end, Key key) {
+    std::vector<Record> records;
+    for (; it != end; ++it)
+        records.push_back(*it);
+    auto less = [&key](const Record& a, const Record& b) { return key(a) < key(b); };
+    if (!std::is_sorted(records.begin(), records.end(), less))
+        std::sort(records.begin(), records.end(), less);
+    return records;
+}
+
+// Binary search for the record of `records` (sorted by `key`) whose key is `k`.
+template <typename Record, typename Key, typename K>
+std::optional<Record> find_sorted(const std::vector<Record>& records, Key key, const K& k) {
+    auto it = std::lower_bound(
+            records.begin(), records.end(), k, [&key](const Record& r, const K& k) {
+                return key(r) < k;
+            });
+    if (it == records.end() || key(*it) != k)
+        return std::nullopt;
+    return *it;
+}
+
+/// Base of the JS classes reading a snapshot `D` (such as `ContactsReadOnlyNode`).  The wrappers'
+/// `exportReadOnly()` returns an instance (see `create`), and `new T(handle)` opens the same
+/// snapshot from any thread.  Each instance holds the snapshot until it is garbage collected.
+template <typename T, typename D>
+class ReadOnlyWrapper : public Napi::ObjectWrap<T> {
+  public:
+    using Data = D;
+
+    // Returns a new `T` reading `data`.  `T::Init` must have been called on this thread.
+    static Napi::Object create(Napi::Env env, const std::shared_ptr<const Data>& data) {
+        auto handle = ReadOnlyRegistry::add(data);
+        return constructor_.New({Napi::Number::New(env, static_cast<double>(handle))});
+    }
+
+    explicit ReadOnlyWrapper(const Napi::CallbackInfo& info) : Napi::ObjectWrap<T>{info} {
+        wrapExceptions(info, [&] {
+            if (!info.IsConstructCall())
+                throw std::invalid_argument{
+                        "You need to call the constructor with the `new` syntax"};
+            assertInfoLength(info, 1);
+            assertIsNumber(info[0]);
+            handle_ = toCppInteger(info[0], "ReadOnly.new", false);
+            data_ = ReadOnlyRegistry::get<Data>(handle_);
+        });
+    }
+
+  protected:
+    // Defines the class, with the given methods and `handle()`, and adds it to `exports`.
+    static void InitClass(
+            Napi::Env env,
+            Napi::Object exports,
+            const char* class_name,
+            std::vector<typename Napi::ObjectWrap<T>::PropertyDescriptor> properties) {
+        properties.push_back(T::InstanceMethod("handle", &ReadOnlyWrapper::handle));
+        auto cls = T::DefineClass(env, class_name, properties);
+        // Each thread has its own environment, so its own class.  The reference is never deleted,
+        // as the environment is gone by the time its thread exits.
+        constructor_ = Napi::Persistent(cls);
+        constructor_.SuppressDestruct();
+        exports.Set(class_name, cls);
+    }
+
+    std::shared_ptr<const Data> data_;
+
+  private:
+    static inline thread_local Napi::FunctionReference constructor_;
+
+    uint64_t handle_ = 0;
+
+    Napi::Value handle(const Napi::CallbackInfo& info) {
+        return wrapResult(info, [&] { return handle_; });
+    }
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,117 @@
+#include "search_index.hpp"
+
+#include <algorithm>
+
+namespace session::nodeapi {
+
+static std::string fold(std::string_view s) {
+    std::string folded{s};
+    for (auto& c : folded)
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+    return folded;
+}
+
+static uint32_t trigram(std::string_view s, size_t pos) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(s[pos])) << 16 |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 1])) << 8 |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 2]));
+}
+
+void NameSearchIndex::index_field(const std::string& id, const std::string& folded) {
+    for (size_t i = 0; i + 3 <= folded.size(); i++)
+        grams_[trigram(folded, i)].insert(id);
+}
+
+void NameSearchIndex::unindex_field(const std::string& id, const std::string& folded) {
+    for (size_t i = 0; i + 3 <= folded.size(); i++) {
+        auto it = grams_.find(trigram(folded, i));
+        if (it == grams_.end())
+            continue;
+        it->second.erase(id);
+        if (it->second.empty())
+            grams_.erase(it);
+    }
+}
+
+void NameSearchIndex::set(const std::string& id, std::string_view name, std::string_view nickname) {
+    erase(id);
+
+    Entry entry{fold(name), fold(nickname)};
+    index_field(id, entry.name);
+    index_field(id, entry.nickname);
+    entries_.emplace(id, std::move(entry));
+}
+
+void NameSearchIndex::erase(const std::string& id) {
+    auto it = entries_.find(id);
+    if (it == entries_.end())
+        return;
+
+    unindex_field(id, it->second.name);
+    unindex_field(id, it->second.nickname);
+    entries_.erase(it);
+}
+
+void NameSearchIndex::clear() {
+    entries_.clear();
+    grams_.clear();
+}
+
+std::vector<std::string> NameSearchIndex::search(std::string_view query, size_t limit) const {
+    auto folded = fold(query);
+
+    // (rank, id) where rank 0 is a prefix match and 1 is a match anywhere else
+    std::vector<std::pair<int, const std::string*>> matches;
+
+    auto consider = [&](const std::string& id, const Entry& entry) {
+        auto name_pos = entry.name.find(folded);
+        auto nick_pos = entry.nickname.find(folded);
+        if (name_pos == std::string::npos && nick_pos == std::string::npos)
+            return;
+        matches.emplace_back(name_pos == 0 || nick_pos == 0 ? 0 : 1, &id);
+    };
+
+    if (folded.size() < 3) {
+        // Too short to use the trigram index, so just scan the (already folded) entries
+        for (const auto& [id, entry] : entries_)
+            consider(id, entry);
+    } else {
+        // Candidates are the ids present in every trigram of the query; start from the smallest
+        // posting list and check the remaining ones (and the actual substring) for each of them.
+        std::vector<const std::unordered_set<std::string>*> postings;
+        for (size_t i = 0; i + 3 <= folded.size(); i++) {
+            auto it = grams_.find(trigram(folded, i));
+            if (it == grams_.end())
+                return {};
+            postings.push_back(&it->second);
+        }
+        auto smallest = *std::min_element(
+                postings.begin(), postings.end(), [](const auto* a, const auto* b) {
+                    return a->size() < b->size();
+                });
+
+        for (const auto& id : *smallest) {
+            if (!std::all_of(postings.begin(), postings.end(), [&](const auto* p) {
+                    return p->count(id) > 0;
+                }))
+                continue;
+            if (auto it = entries_.find(id); it != entries_.end())
+                consider(it->first, it->second);
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first < b.first : *a.second < *b.second;
+    });
+    if (limit > 0 && matches.size() > limit)
+        matches.resize(limit);
+
+    std::vector<std::string> ids;
+    ids.reserve(matches.size());
+    for (const auto& [rank, id] : matches)
+        ids.push_back(*id);
+    return ids;
+}
+
+}  // namespace session::nodeapi
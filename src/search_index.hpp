@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace session::nodeapi {
+
+/// Case-folded trigram index over the name and nickname of config entries (i.e. contacts), keyed
+/// by session id.  The index is maintained incrementally via `set`/`erase`, and answers substring
+/// queries without touching the underlying config.
+///
+/// Case folding is ASCII-only: multi-byte UTF-8 sequences are indexed (and matched) byte for byte.
+class NameSearchIndex {
+  public:
+    // Adds or replaces the entry for `id`.
+    void set(const std::string& id, std::string_view name, std::string_view nickname);
+
+    // Removes the entry for `id`, if present.
+    void erase(const std::string& id);
+
+    void clear();
+
+    size_t size() const { return entries_.size(); }
+
+    // Returns the ids of the entries whose name or nickname contains `query` (case-insensitive).
+    // Entries where the name or nickname *starts* with the query are returned first; ties are
+    // ordered by id.  At most `limit` ids are returned; a limit of 0 means no limit.
+    std::vector<std::string> search(std::string_view query, size_t limit) const;
+
+  private:
+    struct Entry {
+        std::string name;
+        std::string nickname;
+    };
+
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<uint32_t, std::unordered_set<std::string>> grams_;
+
+    void index_field(const std::string& id, const std::string& folded);
+    void unindex_field(const std::string& id, const std::string& folded);
+};
+
+}  // namespace session::nodeapi
@@ -0,0 +1,51 @@
+#include "seen_hashes.hpp"
+
+namespace session::nodeapi {
+
+void SeenHashes::seed(const config::ConfigBase& conf) {
+    if (seeded_)
+        return;
+    seeded_ = true;
+    for (auto& hash : conf.current_hashes())
+        add(std::move(hash));
+}
+
+void SeenHashes::add(std::string hash) {
+    auto [it, inserted] = hashes_.insert(std::move(hash));
+    if (!inserted)
+        return;
+    order_.push_back(&*it);
+    if (order_.size() > MAX_HASHES) {
+        hashes_.erase(hashes_.find(*order_.front()));
+        order_.pop_front();
+    }
+}
+
+std::vector<std::string> SeenHashes::list() const {
+    std::vector<std::string> hashes;
+    hashes.reserve(order_.size());
+    for (const auto* hash : order_)
+        hashes.push_back(*hash);
+    return hashes;
+}
+
+void SeenHashes::clear() {
+    order_.clear();
+    hashes_.clear();
+    seeded_ = false;
+}
+
+void SeenHashes::shrink() {
+    order_.shrink_to_fit();
+    hashes_.rehash(0);
+}
+
+size_t SeenHashes::memoryUsage() const {
+    // Each hash is in a node of the set, plus a pointer to it in the deque
+    size_t bytes = 0;
+    for (const auto& hash : hashes_)
+        bytes += sizeof(hash) + hash.size() + 4 * sizeof(void*);
+    return bytes;
+}
+
+}  // namespace session::nodeapi
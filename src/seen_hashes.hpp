@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "session/config/base.hpp"
+
+namespace session::nodeapi {
+
+/// The hashes of the messages already merged (or pushed) by a config, so that messages the storage
+/// server delivers again are dropped before being decrypted a second time.  Only the latest
+/// `MAX_HASHES` are kept.
+class SeenHashes {
+  public:
+    static constexpr size_t MAX_HASHES = 10'000;
+
+    // Adds the config's current hashes, the first time it is called.  Must be called before any
+    // other method, so that the config's own hashes are known.
+    void seed(const config::ConfigBase& conf);
+
+    bool contains(const std::string& hash) const { return hashes_.count(hash); }
+
+    void add(std::string hash);
+
+    // The hashes, oldest first
+    std::vector<std::string> list() const;
+
+    size_t size() const { return hashes_.size(); }
+
+    // Forgets every hash; the next `seed` starts over from the config.
+    void clear();
+
+    // Gives back the memory left over by evicted hashes.
+    void shrink();
+
+    size_t memoryUsage() const;
+
+  private:
+    // `order_`, used to evict the oldest hashes, points to the hashes in `hashes_`: the elements of
+    // an unordered_set stay where they are (even through a rehash) until erased.
+    std::unordered_set<std::string> hashes_;
+    std::deque<const std::string*> order_;
+    bool seeded_ = false;
+};
+
+}  // namespace session::nodeapi
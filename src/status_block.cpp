@@ -0,0 +1,58 @@
+#include "status_block.hpp"
+
+#include <algorithm>
+
+namespace session::nodeapi {
+
+Napi::Int32Array StatusBlock::get(Napi::Env env, const Status& current) {
+    if (!ref_.IsEmpty() && !ref_.Value().ArrayBuffer().IsDetached())
+        return ref_.Value();
+
+    if (!storage_)
+        storage_ = std::make_shared<Storage>();
+    update(current);
+
+    // The buffer holds its own reference to the storage, which it drops when collected, so that a
+    // buffer outliving its wrapper (or the other way round) never points to freed memory.
+    Napi::ArrayBuffer buffer;
+    auto* hint = new std::shared_ptr<Storage>{storage_};
+    try {
+        buffer = Napi::ArrayBuffer::New(
+                env,
+                storage_->data(),
+                sizeof(Storage),
+                [](Napi::Env, void*, std::shared_ptr<Storage>* storage) { delete storage; },
+                hint);
+        external_ = true;
+    } catch (const Napi::Error&) {
+        // Runtimes with a memory sandbox (such as Electron) refuse external buffers: use a buffer
+        // of their own, which updates copy the values into.
+        delete hint;
+        buffer = Napi::ArrayBuffer::New(env, sizeof(Storage));
+        external_ = false;
+    }
+    ref_ = Napi::Persistent(Napi::Int32Array::New(env, SIZE, buffer, 0));
+    copyOut();
+    return ref_.Value();
+}
+
+void StatusBlock::update(const Status& status) {
+    if (!storage_)
+        return;
+    auto& values = *storage_;
+    values[FLAGS] = (status.needs_push ? NEEDS_PUSH : 0) | (status.needs_dump ? NEEDS_DUMP : 0);
+    values[SEQNO] = static_cast<int32_t>(status.seqno);
+    values[MUTATIONS] = static_cast<int32_t>(status.mutations);
+    copyOut();
+}
+
+void StatusBlock::copyOut() {
+    if (external_ || ref_.IsEmpty())
+        return;
+    auto buffer = ref_.Value().ArrayBuffer();
+    if (buffer.IsDetached())
+        return;
+    std::copy(storage_->begin(), storage_->end(), static_cast<int32_t*>(buffer.Data()));
+}
+
+}  // namespace session::nodeapi
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <napi.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace session::nodeapi {
+
+/// The Int32Array a wrapper's `statusBlock()` returns, kept up to date with the state of its
+/// config so that JS can read that state without a native call.  It is only created by the first
+/// `get()`; until then, updates cost nothing.
+///
+/// The values live in natively owned memory, which the array's buffer shares (and keeps alive)
+/// where the runtime allows external buffers.  JS can still transfer or detach that buffer: `get()`
+/// then hands out a new array, and updates never write through the old one.  Must only be used on
+/// the JS thread.
+class StatusBlock {
+  public:
+    // Layout of the array:
+    static constexpr size_t FLAGS = 0;      // NEEDS_PUSH | NEEDS_DUMP
+    static constexpr size_t SEQNO = 1;      // the last pushed/confirmed seqno (32 bits)
+    static constexpr size_t MUTATIONS = 2;  // incremented on every change to the config
+    static constexpr size_t SIZE = 3;
+    static constexpr int32_t NEEDS_PUSH = 1 << 0;
+    static constexpr int32_t NEEDS_DUMP = 1 << 1;
+
+    struct Status {
+        bool needs_push;
+        bool needs_dump;
+        int64_t seqno;
+        uint32_t mutations;
+    };
+
+    // Returns the array, creating it (from `current`) on the first call, or if the previous one was
+    // detached.
+    Napi::Int32Array get(Napi::Env env, const Status& current);
+
+    // Whether the array was created, i.e. whether `update` does anything.
+    bool active() const { return storage_ != nullptr; }
+
+    void update(const Status& status);
+
+  private:
+    using Storage = std::array<int32_t, SIZE>;
+
+    // Copies the values into the JS buffer, when it is not the native storage itself
+    void copyOut();
+
+    std::shared_ptr<Storage> storage_;
+    Napi::Reference<Napi::Int32Array> ref_;
+    // Whether the array's buffer is `storage_` (rather than a JS-allocated copy of it)
+    bool external_ = false;
+};
+
+}  // namespace session::nodeapi
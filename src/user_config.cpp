@@ -29,20 +29,22 @@ void UserConfigWrapper::Init(Napi::Env env, Napi::Object exports) {
 
 UserConfigWrapper::UserConfigWrapper(const Napi::CallbackInfo& info) :
         ConfigBaseImpl{construct<config::UserProfile>(info, "UserConfig")},
-        Napi::ObjectWrap<UserConfigWrapper>{info} {}
+        Napi::ObjectWrap<UserConfigWrapper>{info} {
+    tagInstance<UserConfigWrapper>(info);
+}
 
 Napi::Value UserConfigWrapper::getUserInfo(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&] {
         auto env = info.Env();
         auto user_info_obj = Napi::Object::New(env);
 
-        auto name = config.get_name();
-        auto priority = config.get_nts_priority();
+        auto name = config().get_name();
+        auto priority = config().get_nts_priority();
 
         user_info_obj["name"] = toJs(env, name);
         user_info_obj["priority"] = toJs(env, priority);
 
-        auto profile_pic_obj = object_from_profile_pic(env, config.get_profile_pic());
+        auto profile_pic_obj = object_from_profile_pic(env, config().get_profile_pic());
         if (profile_pic_obj) {
             user_info_obj["url"] = profile_pic_obj.Get("url");
             user_info_obj["key"] = profile_pic_obj.Get("key");
@@ -70,24 +72,25 @@ Napi::Value UserConfigWrapper::setUserInfo(const Napi::CallbackInfo& info) {
         if (name.IsString())
             new_name = name.As<Napi::String>().Utf8Value();
 
-        config.set_name_truncated(new_name);
+        Mutation mutation{*this};
+        config().set_name_truncated(new_name);
 
-        auto new_priority = toPriority(priority, config.get_nts_priority());
-        config.set_nts_priority(new_priority);
+        auto new_priority = toPriority(priority, config().get_nts_priority());
+        config().set_nts_priority(new_priority);
 
         if (!profile_pic_obj.IsNull() && !profile_pic_obj.IsUndefined())
             assertIsObject(profile_pic_obj);
 
-        config.set_profile_pic(profile_pic_from_object(profile_pic_obj));
+        config().set_profile_pic(profile_pic_from_object(profile_pic_obj));
 
-        return config.get_name();
+        return config().get_name();
     });
 }
 
 Napi::Value UserConfigWrapper::getEnableBlindedMsgRequest(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&] {
         auto env = info.Env();
-        auto blindedMsgRequest = toJs(env, config.get_blinded_msgreqs());
+        auto blindedMsgRequest = toJs(env, config().get_blinded_msgreqs());
 
         return blindedMsgRequest;
     });
@@ -101,13 +104,14 @@ void UserConfigWrapper::setEnableBlindedMsgRequest(const Napi::CallbackInfo& inf
         assertIsBoolean(blindedMsgRequests);
 
         auto blindedMsgReqCpp = toCppBoolean(blindedMsgRequests, "set_blinded_msgreqs");
-        config.set_blinded_msgreqs(blindedMsgReqCpp);
+        Mutation mutation{*this};
+        config().set_blinded_msgreqs(blindedMsgReqCpp);
     });
 }
 
 Napi::Value UserConfigWrapper::getNoteToSelfExpiry(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&] {
-        auto nts_expiry = config.get_nts_expiry();
+        auto nts_expiry = config().get_nts_expiry();
         if (nts_expiry) {
             return nts_expiry->count();
         }
@@ -124,7 +128,8 @@ void UserConfigWrapper::setNoteToSelfExpiry(const Napi::CallbackInfo& info) {
         assertIsNumber(expirySeconds);
 
         auto expiryCppSeconds = toCppInteger(expirySeconds, "set_nts_expiry", false);
-        config.set_nts_expiry(std::chrono::seconds{expiryCppSeconds});
+        Mutation mutation{*this};
+        config().set_nts_expiry(std::chrono::seconds{expiryCppSeconds});
     });
 }
 
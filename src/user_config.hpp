@@ -15,7 +15,7 @@ class UserConfigWrapper : public ConfigBaseImpl, public Napi::ObjectWrap<UserCon
     explicit UserConfigWrapper(const Napi::CallbackInfo& info);
 
   private:
-    config::UserProfile& config{get_config<config::UserProfile>()};
+    config::UserProfile& config() { return get_config<config::UserProfile>(); }
 
     Napi::Value getUserInfo(const Napi::CallbackInfo& info);
     Napi::Value setUserInfo(const Napi::CallbackInfo& info);
@@ -7,6 +7,7 @@
 
 #include "base_config.hpp"
 #include "community.hpp"
+#include "query.hpp"
 #include "session/config/user_groups.hpp"
 #include "session/types.hpp"
 
@@ -16,16 +17,6 @@ using config::community_info;
 using config::legacy_group_info;
 using config::UserGroups;
 
-template <>
-struct toJs_impl<community_info> : toJs_impl<config::community> {
-    Napi::Object operator()(const Napi::Env& env, const community_info& info_comm) {
-        auto obj = toJs_impl<config::community>::operator()(env, info_comm);
-        obj["priority"] = toJs(env, info_comm.priority);
-
-        return obj;
-    }
-};
-
 static Napi::Array members_array(const Napi::Env& env, const std::map<std::string, bool>& members) {
     auto mems = Napi::Array::New(env, members.size());
     size_t i = 0;
@@ -38,20 +29,52 @@ static Napi::Array members_array(const Napi::Env& env, const std::map<std::strin
     return mems;
 }
 
+static const auto community_fields = community_query_fields<community_info>({
+        {"priority", [](const community_info& c) -> FieldValue { return int64_t{c.priority}; }},
+});
+
+static const QueryFields<legacy_group_info> legacy_group_fields{
+        {"pubkeyHex", [](const legacy_group_info& g) -> FieldValue { return g.session_id; }},
+        {"name", [](const legacy_group_info& g) -> FieldValue { return g.name; }},
+        {"encPubkey",
+         nullptr,
+         [](const Napi::Env& env, const legacy_group_info& g) -> Napi::Value {
+             return toJs(env, g.enc_pubkey);
+         }},
+        {"encSeckey",
+         nullptr,
+         [](const Napi::Env& env, const legacy_group_info& g) -> Napi::Value {
+             return toJs(env, g.enc_seckey);
+         }},
+        {"disappearingTimerSeconds",
+         [](const legacy_group_info& g) -> FieldValue {
+             return int64_t{g.disappearing_timer.count()};
+         }},
+        {"priority", [](const legacy_group_info& g) -> FieldValue { return int64_t{g.priority}; }},
+        {"joinedAtSeconds", [](const legacy_group_info& g) -> FieldValue { return g.joined_at; }},
+        {"members",
+         nullptr,
+         [](const Napi::Env& env, const legacy_group_info& g) -> Napi::Value {
+             return members_array(env, g.members());
+         }},
+};
+
 template <>
-struct toJs_impl<legacy_group_info> {
-    Napi::Object operator()(const Napi::Env& env, const legacy_group_info& legacy_group) {
-        auto obj = Napi::Object::New(env);
-
-        obj["pubkeyHex"] = toJs(env, legacy_group.session_id);
-        obj["name"] = toJs(env, legacy_group.name);
-        obj["encPubkey"] = toJs(env, legacy_group.enc_pubkey);
-        obj["encSeckey"] = toJs(env, legacy_group.enc_seckey);
-        obj["disappearingTimerSeconds"] = toJs(env, legacy_group.disappearing_timer.count());
-        obj["priority"] = toJs(env, legacy_group.priority);
-        obj["joinedAtSeconds"] = toJs(env, legacy_group.joined_at);
-        obj["members"] = members_array(env, legacy_group.members());
+struct toJs_impl<community_info> {
+    Napi::Object operator()(const Napi::Env& env, const community_info& info_comm) {
+        return object_from_fields(env, community_fields, info_comm);
+    }
+};
 
+template <>
+struct toJs_impl<legacy_group_info> {
+    Napi::Object operator()(
+            const Napi::Env& env,
+            const legacy_group_info& legacy_group,
+            BufferSlab* slab = nullptr) {
+        auto obj = object_from_fields(env, legacy_group_fields, legacy_group);
+        if (slab)
+            obj["encPubkey"] = slab->view(legacy_group.enc_pubkey);
         return obj;
     }
 };
@@ -68,6 +91,7 @@ void UserGroupsWrapper::Init(Napi::Env env, Napi::Object exports) {
                     InstanceMethod(
                             "setCommunityByFullUrl", &UserGroupsWrapper::setCommunityByFullUrl),
                     InstanceMethod("getAllCommunities", &UserGroupsWrapper::getAllCommunities),
+                    InstanceMethod("queryCommunities", &UserGroupsWrapper::queryCommunities),
                     InstanceMethod(
                             "eraseCommunityByFullUrl", &UserGroupsWrapper::eraseCommunityByFullUrl),
                     InstanceMethod(
@@ -76,14 +100,19 @@ void UserGroupsWrapper::Init(Napi::Env env, Napi::Object exports) {
                     // Legacy groups related methods
                     InstanceMethod("getLegacyGroup", &UserGroupsWrapper::getLegacyGroup),
                     InstanceMethod("getAllLegacyGroups", &UserGroupsWrapper::getAllLegacyGroups),
+                    InstanceMethod("queryLegacyGroups", &UserGroupsWrapper::queryLegacyGroups),
                     InstanceMethod("setLegacyGroup", &UserGroupsWrapper::setLegacyGroup),
                     InstanceMethod("eraseLegacyGroup", &UserGroupsWrapper::eraseLegacyGroup),
+
+                    InstanceMethod("exportReadOnly", &UserGroupsWrapper::exportReadOnly),
             });
 }
 
 UserGroupsWrapper::UserGroupsWrapper(const Napi::CallbackInfo& info) :
         ConfigBaseImpl{construct<UserGroups>(info, "UserGroups")},
-        Napi::ObjectWrap<UserGroupsWrapper>{info} {}
+        Napi::ObjectWrap<UserGroupsWrapper>{info} {
+    tagInstance<UserGroupsWrapper>(info);
+}
 
 /**
  * =================================================
@@ -92,7 +121,7 @@ UserGroupsWrapper::UserGroupsWrapper(const Napi::CallbackInfo& info) :
  */
 
 Napi::Value UserGroupsWrapper::getCommunityByFullUrl(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.get_community(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] { return config().get_community(getStringArgs<1>(info)); });
 }
 
 void UserGroupsWrapper::setCommunityByFullUrl(const Napi::CallbackInfo& info) {
@@ -100,25 +129,38 @@ void UserGroupsWrapper::setCommunityByFullUrl(const Napi::CallbackInfo& info) {
         assertInfoLength(info, 2);
         auto first = info[0];
         assertIsString(first);
-        auto createdOrFound = config.get_or_construct_community(
+        auto createdOrFound = config().get_or_construct_community(
                 toCppString(first, "group.SetCommunityByFullUrl"));
 
         auto second = info[1];
         assertIsNumber(second);
         createdOrFound.priority = toPriority(second, createdOrFound.priority);
 
-        config.set(createdOrFound);
+        Mutation mutation{*this};
+        config().set(createdOrFound);
     });
 }
 
 Napi::Value UserGroupsWrapper::getAllCommunities(const Napi::CallbackInfo& info) {
-    return get_all_impl(info, config.size_communities(), config.begin_communities(), config.end());
+    return get_all_impl(
+            info, config().size_communities(), config().begin_communities(), config().end());
+}
+
+Napi::Value UserGroupsWrapper::queryCommunities(const Napi::CallbackInfo& info) {
+    return query_impl(
+            info,
+            community_fields,
+            config().begin_communities(),
+            config().end(),
+            "userGroups.queryCommunities");
 }
 
 Napi::Value UserGroupsWrapper::eraseCommunityByFullUrl(const Napi::CallbackInfo& info) {
     return wrapResult(info, [&] {
         auto [base, room, pubkey] = config::community::parse_full_url(getStringArgs<1>(info));
-        return config.erase_community(base, room);
+        Mutation mutation{*this};
+        auto erased = config().erase_community(base, room);
+        return erased;
     });
 }
 
@@ -143,12 +185,32 @@ Napi::Value UserGroupsWrapper::buildFullUrlFromDetails(const Napi::CallbackInfo&
  */
 
 Napi::Value UserGroupsWrapper::getLegacyGroup(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.get_legacy_group(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] { return config().get_legacy_group(getStringArgs<1>(info)); });
 }
 
 Napi::Value UserGroupsWrapper::getAllLegacyGroups(const Napi::CallbackInfo& info) {
-    return get_all_impl(
-            info, config.size_legacy_groups(), config.begin_legacy_groups(), config.end());
+    auto env = info.Env();
+    return wrapExceptions(env, [&] {
+        assertInfoLength(info, 0);
+
+        // The encryption pubkeys (32 bytes each) are views into this single buffer; the secret keys
+        // stay in their own buffers (see BufferSlab).
+        BufferSlab slab{env, config().size_legacy_groups() * 32};
+        auto groups = Napi::Array::New(env, config().size_legacy_groups());
+        size_t i = 0;
+        for (auto it = config().begin_legacy_groups(); it != config().end(); it++)
+            groups[i++] = toJs_impl<legacy_group_info>{}(env, *it, &slab);
+        return groups;
+    });
+}
+
+Napi::Value UserGroupsWrapper::queryLegacyGroups(const Napi::CallbackInfo& info) {
+    return query_impl(
+            info,
+            legacy_group_fields,
+            config().begin_legacy_groups(),
+            config().end(),
+            "userGroups.queryLegacyGroups");
 }
 
 void UserGroupsWrapper::setLegacyGroup(const Napi::CallbackInfo& info) {
@@ -159,7 +221,7 @@ void UserGroupsWrapper::setLegacyGroup(const Napi::CallbackInfo& info) {
         assertIsObject(legacyGroupValue);
         auto obj = legacyGroupValue.As<Napi::Object>();
 
-        auto group = config.get_or_construct_legacy_group(
+        auto group = config().get_or_construct_legacy_group(
                 toCppString(obj.Get("pubkeyHex"), "legacyGroup.set"));
 
         group.priority = toPriority(obj.Get("priority"), group.priority);
@@ -228,12 +290,111 @@ void UserGroupsWrapper::setLegacyGroup(const Napi::CallbackInfo& info) {
             group.erase(sid);
         }
 
-        config.set(group);
+        Mutation mutation{*this};
+        config().set(group);
     });
 }
 
 Napi::Value UserGroupsWrapper::eraseLegacyGroup(const Napi::CallbackInfo& info) {
-    return wrapResult(info, [&] { return config.erase_legacy_group(getStringArgs<1>(info)); });
+    return wrapResult(info, [&] {
+        Mutation mutation{*this};
+        auto erased = config().erase_legacy_group(getStringArgs<1>(info));
+        return erased;
+    });
+}
+
+/**
+ * =================================================
+ * =================== Read-only ===================
+ * =================================================
+ */
+
+struct UserGroupsReadOnlyData : ReadOnlyRegistry::Data {
+    // In libsession's order, for lookups
+    std::vector<community_info> communities;
+    std::vector<legacy_group_info> legacy_groups;
+};
+
+static const std::string& legacy_group_id(const legacy_group_info& g) {
+    return g.session_id;
+}
+
+Napi::Value UserGroupsWrapper::exportReadOnly(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        assertInfoLength(info, 0);
+        auto data = std::make_shared<UserGroupsReadOnlyData>();
+        auto& conf = config();
+        data->communities = copy_sorted<community_info>(
+                conf.begin_communities(), conf.end(), community_key<community_info>);
+        data->legacy_groups = copy_sorted<legacy_group_info>(
+                conf.begin_legacy_groups(), conf.end(), legacy_group_id);
+        return UserGroupsReadOnlyWrapper::create(info.Env(), data);
+    });
+}
+
+void UserGroupsReadOnlyWrapper::Init(Napi::Env env, Napi::Object exports) {
+    InitClass(
+            env,
+            exports,
+            "UserGroupsReadOnlyNode",
+            {
+                    InstanceMethod(
+                            "getCommunityByFullUrl",
+                            &UserGroupsReadOnlyWrapper::getCommunityByFullUrl),
+                    InstanceMethod(
+                            "getAllCommunities", &UserGroupsReadOnlyWrapper::getAllCommunities),
+                    InstanceMethod("getLegacyGroup", &UserGroupsReadOnlyWrapper::getLegacyGroup),
+                    InstanceMethod(
+                            "getAllLegacyGroups", &UserGroupsReadOnlyWrapper::getAllLegacyGroups),
+            });
+}
+
+Napi::Value UserGroupsReadOnlyWrapper::getCommunityByFullUrl(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        auto [base, room, pubkey] = config::community::parse_full_url(getStringArgs<1>(info));
+        auto room_norm = community_room_norm(room);
+        return find_sorted(
+                data_->communities, community_key<community_info>, CommunityKey{base, room_norm});
+    });
+}
+
+Napi::Value UserGroupsReadOnlyWrapper::getAllCommunities(const Napi::CallbackInfo& info) {
+    return get_all_impl(
+            info,
+            data_->communities.size(),
+            data_->communities.begin(),
+            data_->communities.end());
+}
+
+Napi::Value UserGroupsReadOnlyWrapper::getLegacyGroup(const Napi::CallbackInfo& info) {
+    return wrapResult(info, [&] {
+        return find_sorted(data_->legacy_groups, legacy_group_id, getStringArgs<1>(info));
+    });
+}
+
+Napi::Value UserGroupsReadOnlyWrapper::getAllLegacyGroups(const Napi::CallbackInfo& info) {
+    return get_all_impl(
+            info,
+            data_->legacy_groups.size(),
+            data_->legacy_groups.begin(),
+            data_->legacy_groups.end());
+}
+
+auto UserGroupsWrapper::collectionUsage() -> std::vector<CollectionUsage> {
+    CollectionUsage communities{"communities"}, legacy_groups{"legacyGroups"};
+    for (auto it = config().begin_communities(); it != config().end(); it++) {
+        communities.entries++;
+        // (+ the pubkey, which is kept as bytes)
+        communities.bytes += sizeof(*it) + it->base_url().size() + it->room().size() + 32;
+    }
+    for (auto it = config().begin_legacy_groups(); it != config().end(); it++) {
+        legacy_groups.entries++;
+        legacy_groups.bytes += sizeof(*it) + it->session_id.size() + it->name.size() +
+                               it->enc_pubkey.size() + it->enc_seckey.size();
+        for (const auto& [sid, admin] : it->members())
+            legacy_groups.bytes += sizeof(sid) + sid.size() + sizeof(admin);
+    }
+    return {communities, legacy_groups};
 }
 
 }  // namespace session::nodeapi
@@ -3,6 +3,7 @@
 #include <napi.h>
 
 #include "base_config.hpp"
+#include "readonly_registry.hpp"
 #include "session/config/user_groups.hpp"
 
 namespace session::nodeapi {
@@ -14,20 +15,45 @@ class UserGroupsWrapper : public ConfigBaseImpl, public Napi::ObjectWrap<UserGro
     explicit UserGroupsWrapper(const Napi::CallbackInfo& info);
 
   private:
-    config::UserGroups& config{get_config<config::UserGroups>()};
+    config::UserGroups& config() { return get_config<config::UserGroups>(); }
+
+    std::vector<CollectionUsage> collectionUsage() override;
 
     // Communities related methods
     Napi::Value getCommunityByFullUrl(const Napi::CallbackInfo& info);
     void setCommunityByFullUrl(const Napi::CallbackInfo& info);
     Napi::Value getAllCommunities(const Napi::CallbackInfo& info);
+    Napi::Value queryCommunities(const Napi::CallbackInfo& info);
     Napi::Value eraseCommunityByFullUrl(const Napi::CallbackInfo& info);
     Napi::Value buildFullUrlFromDetails(const Napi::CallbackInfo& info);
 
     // Legacy groups related methods
     Napi::Value getLegacyGroup(const Napi::CallbackInfo& info);
     Napi::Value getAllLegacyGroups(const Napi::CallbackInfo& info);
+    Napi::Value queryLegacyGroups(const Napi::CallbackInfo& info);
     void setLegacyGroup(const Napi::CallbackInfo& info);
     Napi::Value eraseLegacyGroup(const Napi::CallbackInfo& info);
+
+    Napi::Value exportReadOnly(const Napi::CallbackInfo& info);
+};
+
+struct UserGroupsReadOnlyData;
+
+/// Immutable copy of the communities and legacy groups, returned by
+/// `UserGroupsWrapper.exportReadOnly()` and opened from any thread by its handle (see
+/// ReadOnlyWrapper).
+class UserGroupsReadOnlyWrapper
+        : public ReadOnlyWrapper<UserGroupsReadOnlyWrapper, UserGroupsReadOnlyData> {
+  public:
+    static void Init(Napi::Env env, Napi::Object exports);
+
+    using ReadOnlyWrapper::ReadOnlyWrapper;
+
+  private:
+    Napi::Value getCommunityByFullUrl(const Napi::CallbackInfo& info);
+    Napi::Value getAllCommunities(const Napi::CallbackInfo& info);
+    Napi::Value getLegacyGroup(const Napi::CallbackInfo& info);
+    Napi::Value getAllLegacyGroups(const Napi::CallbackInfo& info);
 };
 
 }  // namespace session::nodeapi
@@ -153,7 +153,10 @@ std::string printable(ustring_view x) {
 }
 
 int64_t toPriority(Napi::Value x, int64_t currentPriority) {
-    auto newPriority = toCppInteger(x, "toPriority", true);
+    return toPriority(toCppInteger(x, "toPriority", true), currentPriority);
+}
+
+int64_t toPriority(int64_t newPriority, int64_t currentPriority) {
     if (newPriority > 0)
         // keep the existing priority if it is already set
         return std::max<int64_t>(currentPriority, 1);
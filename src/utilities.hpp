@@ -2,6 +2,7 @@
 
 #include <napi.h>
 
+#include <cstring>
 #include <optional>
 #include <string_view>
 #include <type_traits>
@@ -131,6 +132,39 @@ struct toJs_impl<std::optional<T>> {
     }
 };
 
+// Hands out Buffers viewing a single allocation, so that bulk getters returning many small
+// buffers make one allocation per call rather than one per buffer.  `capacity` should be the total
+// number of bytes that will be handed out; if it runs out, `view()` falls back to allocating a
+// standalone buffer.  Every view gives access to the whole slab (through its `.buffer`), so it must
+// only hold data that is fine to hand out together: never secret keys.
+class BufferSlab {
+  public:
+    BufferSlab(const Napi::Env& env, size_t capacity) :
+            env_{env}, buffer_{Napi::Buffer<uint8_t>::New(env, capacity)} {}
+
+    // Copies `data` into the slab and returns a Buffer viewing it.
+    Napi::Buffer<uint8_t> view(ustring_view data) {
+        if (data.size() > buffer_.Length() - offset_)
+            return Napi::Buffer<uint8_t>::Copy(env_, data.data(), data.size());
+        std::memcpy(buffer_.Data() + offset_, data.data(), data.size());
+        // (Buffer's subarray returns a Buffer, sharing the slab's memory)
+        if (subarray_.IsEmpty())
+            subarray_ = buffer_.Get("subarray").As<Napi::Function>();
+        auto view = subarray_.Call(
+                buffer_,
+                {Napi::Number::New(env_, static_cast<double>(offset_)),
+                 Napi::Number::New(env_, static_cast<double>(offset_ + data.size()))});
+        offset_ += data.size();
+        return view.As<Napi::Buffer<uint8_t>>();
+    }
+
+  private:
+    Napi::Env env_;
+    Napi::Buffer<uint8_t> buffer_;
+    Napi::Function subarray_;
+    size_t offset_ = 0;
+};
+
 // Helper for various "get_all" functions that copy [it...end) into a Napi::Array via toJs().
 // Throws a Napi::Error on any exception.
 template <typename It, typename EndIt>
@@ -216,6 +250,8 @@ std::string printable(ustring_view x);
  * Keep the current priority if a wrapper
  */
 int64_t toPriority(Napi::Value x, int64_t currentPriority);
+// Same, once the priority was read from the JS value
+int64_t toPriority(int64_t newPriority, int64_t currentPriority);
 
 int64_t unix_timestamp_now();
 
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <napi.h>
+#include <sodium/core.h>
+#include <sodium/crypto_sign_ed25519.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../meta/meta_base_wrapper.hpp"
+#include "../parallel.hpp"
+#include "../utilities.hpp"
+#include "oxenc/hex.h"
+
+namespace session::nodeapi {
+
+/// All-static wrapper verifying batches of ed25519 signatures (including the ones made with
+/// blinded keys, which are plain ed25519 signatures for the blinded pubkey) across threads.
+class VerificationWrapper : public Napi::ObjectWrap<VerificationWrapper> {
+
+  public:
+    VerificationWrapper(const Napi::CallbackInfo& info) :
+            Napi::ObjectWrap<VerificationWrapper>{info} {
+        throw std::invalid_argument(
+                "VerificationWrapper is all static and don't need to be constructed");
+    }
+
+    static void Init(Napi::Env env, Napi::Object exports) {
+        if (sodium_init() < 0)
+            throw std::runtime_error{"VerificationWrapper: failed to initialize libsodium"};
+
+        MetaBaseWrapper::NoBaseClassInitHelper<VerificationWrapper>(
+                env,
+                exports,
+                "VerificationWrapperNode",
+                {
+                        StaticMethod<&VerificationWrapper::verifyMany>(
+                                "verifyMany",
+                                static_cast<napi_property_attributes>(
+                                        napi_writable | napi_configurable)),
+                        StaticMethod<&VerificationWrapper::verifyManyAsync>(
+                                "verifyManyAsync",
+                                static_cast<napi_property_attributes>(
+                                        napi_writable | napi_configurable)),
+                });
+    }
+
+  private:
+    struct Item {
+        ustring pubkey;
+        ustring_view message;
+        ustring_view signature;
+    };
+
+    // Parses the `[{pubkey, message, signature}]` argument.  The pubkey can be given as 32 bytes or
+    // as hex, optionally with an ed25519-style prefix (00, 07, 15 or 25); any other prefix throws.
+    // Message and signature are views into the JS buffers unless `storage` is given, in which case
+    // they are copied in there first (for use beyond the current call).
+    static std::vector<Item> parseItems(
+            const Napi::CallbackInfo& info, std::vector<ustring>* storage = nullptr) {
+        assertInfoLength(info, 1);
+        assertIsArray(info[0]);
+        auto arr = info[0].As<Napi::Array>();
+
+        std::vector<Item> items;
+        items.reserve(arr.Length());
+        if (storage)
+            storage->reserve(2 * arr.Length());
+
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            auto val = arr.Get(i);
+            assertIsObject(val);
+            auto obj = val.As<Napi::Object>();
+            auto& item = items.emplace_back();
+
+            auto pubkey = obj.Get("pubkey");
+            if (pubkey.IsString()) {
+                auto hex = toCppString(pubkey, "verifyMany.pubkey");
+                if (hex.size() == 66) {
+                    // Only the prefixes of ids holding an ed25519 pubkey: a 05 session id is an
+                    // x25519 pubkey, which would never verify anything.
+                    auto prefix = std::string_view{hex}.substr(0, 2);
+                    if (prefix != "00" && prefix != "07" && prefix != "15" && prefix != "25")
+                        throw std::invalid_argument{
+                                "verifyMany: invalid pubkey prefix '" + std::string{prefix} +
+                                "': expected 00, 07, 15 or 25"};
+                    hex.erase(0, 2);
+                }
+                if (hex.size() != 64 || !oxenc::is_hex(hex.begin(), hex.end()))
+                    throw std::invalid_argument{"verifyMany: invalid pubkey hex"};
+                oxenc::from_hex(hex.begin(), hex.end(), std::back_inserter(item.pubkey));
+            } else {
+                item.pubkey = toCppBuffer(pubkey, "verifyMany.pubkey");
+            }
+
+            item.message = toCppBufferView(obj.Get("message"), "verifyMany.message");
+            item.signature = toCppBufferView(obj.Get("signature"), "verifyMany.signature");
+            if (storage) {
+                item.message = storage->emplace_back(item.message);
+                item.signature = storage->emplace_back(item.signature);
+            }
+        }
+        return items;
+    }
+
+    // Returns a bitmap where bit `i % 8` of byte `i / 8` is set if the signature of item `i` is
+    // valid.
+    static ustring verifyAll(const std::vector<Item>& items) {
+        std::vector<unsigned char> valid(items.size());
+        parallel_for(
+                items.size(),
+                [&](size_t i) {
+                    const auto& item = items[i];
+                    valid[i] = item.pubkey.size() == 32 && item.signature.size() == 64 &&
+                               0 == crypto_sign_ed25519_verify_detached(
+                                            item.signature.data(),
+                                            item.message.data(),
+                                            item.message.size(),
+                                            item.pubkey.data());
+                },
+                32);
+
+        ustring bitmap((items.size() + 7) / 8, 0);
+        for (size_t i = 0; i < items.size(); i++)
+            if (valid[i])
+                bitmap[i / 8] |= 1 << (i % 8);
+        return bitmap;
+    }
+
+    class VerifyManyWorker : public Napi::AsyncWorker {
+      public:
+        VerifyManyWorker(
+                const Napi::Env& env, std::vector<Item> items, std::vector<ustring> storage) :
+                Napi::AsyncWorker{env},
+                deferred_{Napi::Promise::Deferred::New(env)},
+                items_{std::move(items)},
+                storage_{std::move(storage)} {}
+
+        Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+      protected:
+        void Execute() override { bitmap_ = verifyAll(items_); }
+        void OnOK() override { deferred_.Resolve(toJs(Env(), bitmap_)); }
+        void OnError(const Napi::Error& e) override { deferred_.Reject(e.Value()); }
+
+      private:
+        Napi::Promise::Deferred deferred_;
+        std::vector<Item> items_;
+        std::vector<ustring> storage_;  // owns the data items_ views into
+        ustring bitmap_;
+    };
+
+    static Napi::Value verifyMany(const Napi::CallbackInfo& info) {
+        return wrapResult(info, [&] { return verifyAll(parseItems(info)); });
+    }
+
+    static Napi::Value verifyManyAsync(const Napi::CallbackInfo& info) {
+        return wrapExceptions(info, [&] {
+            std::vector<ustring> storage;
+            auto items = parseItems(info, &storage);
+            auto* worker = new VerifyManyWorker{info.Env(), std::move(items), std::move(storage)};
+            auto promise = worker->GetPromise();
+            worker->Queue();
+            return promise;
+        });
+    }
+};
+
+}  // namespace session::nodeapi
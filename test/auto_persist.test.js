@@ -0,0 +1,79 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const fs = require('node:fs');
+const os = require('node:os');
+const path = require('node:path');
+const { setTimeout: sleep } = require('node:timers/promises');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+function contactsWrapper() {
+  const { ContactsConfigWrapperNode } = addon();
+  return new ContactsConfigWrapperNode(randomSecretKey(), null);
+}
+
+function tmpDir() {
+  return fs.mkdtempSync(path.join(os.tmpdir(), 'libsession-persist-'));
+}
+
+test('autoPersist writes the dump to the file once the config changed', async () => {
+  const file = path.join(tmpDir(), 'contacts');
+  const contacts = contactsWrapper();
+  contacts.autoPersist({ path: file, debounceMs: 5 });
+  contacts.set(makeContact({}));
+  contacts.set(makeContact({}));
+
+  await sleep(100);
+  assert.strictEqual(contacts.needsDump(), false);
+  assert.strictEqual(fs.readFileSync(file).length, contacts.persistStats().bytesWritten);
+  assert.strictEqual(contacts.persistStats().dumps, 1);
+  assert.strictEqual(contacts.persistStats().coalescedMutations, 1);
+  assert.deepStrictEqual(fs.readdirSync(path.dirname(file)), ['contacts']);
+});
+
+test('a failed write leaves the config needing a dump', () => {
+  const file = path.join(tmpDir(), 'missing', 'contacts');
+  const contacts = contactsWrapper();
+  contacts.autoPersist({ path: file });
+  contacts.set(makeContact({}));
+
+  assert.strictEqual(contacts.flushPersist(), true);
+  assert.strictEqual(contacts.persistStats().writeErrors, 1);
+  assert.strictEqual(contacts.needsDump(), true);
+
+  fs.mkdirSync(path.dirname(file));
+  assert.strictEqual(contacts.flushPersist(), true);
+  assert.strictEqual(contacts.needsDump(), false);
+  assert.ok(fs.existsSync(file));
+});
+
+test('a failed write is retried until it succeeds', async () => {
+  const file = path.join(tmpDir(), 'missing', 'contacts');
+  const contacts = contactsWrapper();
+  contacts.autoPersist({ path: file, debounceMs: 5 });
+  contacts.set(makeContact({}));
+
+  await sleep(100);
+  const { writeErrors } = contacts.persistStats();
+  assert.ok(writeErrors >= 2);
+  assert.strictEqual(contacts.needsDump(), true);
+
+  // Retries back off (5ms, 10ms, 20ms...), so the next one comes within a few hundred ms
+  fs.mkdirSync(path.dirname(file));
+  await sleep(500);
+  assert.strictEqual(contacts.needsDump(), false);
+  assert.ok(fs.existsSync(file));
+  assert.strictEqual(contacts.persistStats().dumps, contacts.persistStats().writeErrors + 1);
+});
+
+test('autoPersist hands the dump to a sink function', async () => {
+  const contacts = contactsWrapper();
+  const dumps = [];
+  contacts.autoPersist({ sink: dump => dumps.push(dump), debounceMs: 5 });
+  contacts.set(makeContact({}));
+
+  await sleep(100);
+  assert.strictEqual(dumps.length, 1);
+  assert.strictEqual(contacts.flushPersist(), false);
+  assert.throws(() => contacts.autoPersist({}), /exactly one of path and sink/);
+});
@@ -0,0 +1,38 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+const serverPubkey = 'aa'.repeat(32);
+
+test('the index follows the changes of its wrappers without refresh()', () => {
+  const { UserGroupsWrapperNode, ContactsConfigWrapperNode, BlindedIdIndexNode } = addon();
+  const userGroups = new UserGroupsWrapperNode(randomSecretKey(), null);
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  const index = new BlindedIdIndexNode(userGroups, contacts);
+  assert.strictEqual(index.size(), 0);
+
+  userGroups.setCommunityByFullUrl(`https://example.org/room?public_key=${serverPubkey}`, 0);
+  const contact = makeContact({});
+  contacts.set(contact);
+  // one 25 and two 15 blinded ids for the single (contact, server) pair
+  assert.strictEqual(index.size(), 3);
+  assert.strictEqual(index.refresh(), 0);
+
+  contacts.erase(contact.id);
+  assert.strictEqual(index.size(), 0);
+  assert.strictEqual(index.lookupBlinded('15' + '00'.repeat(32)), null);
+});
+
+test('refresh() reports the pairs computed', () => {
+  const { UserGroupsWrapperNode, ContactsConfigWrapperNode, BlindedIdIndexNode } = addon();
+  const userGroups = new UserGroupsWrapperNode(randomSecretKey(), null);
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  const index = new BlindedIdIndexNode(userGroups, contacts);
+
+  userGroups.setCommunityByFullUrl(`https://example.org/room?public_key=${serverPubkey}`, 0);
+  for (let i = 0; i < 20; i++) contacts.set(makeContact({}));
+  assert.strictEqual(index.refresh(), 20);
+  assert.strictEqual(index.refresh(), 0);
+  assert.strictEqual(index.size(), 60);
+});
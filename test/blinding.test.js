@@ -0,0 +1,28 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey } = require('./helpers');
+
+test('BlindingContextNode signs exactly as BlindingWrapperNode', () => {
+  const { BlindingWrapperNode, BlindingContextNode } = addon();
+  const ed25519SecretKey = randomSecretKey();
+  const context = new BlindingContextNode({ ed25519SecretKey });
+
+  assert.strictEqual(
+    context.blindVersionPubkey(),
+    BlindingWrapperNode.blindVersionPubkey({ ed25519SecretKey })
+  );
+
+  const timestamps = [0, 1, 1700000000, Math.floor(Date.now() / 1000)];
+  const expected = timestamps.map(sigTimestampSeconds =>
+    BlindingWrapperNode.blindVersionSign({ ed25519SecretKey, sigTimestampSeconds })
+  );
+  assert.deepStrictEqual(timestamps.map(ts => context.blindVersionSign(ts)), expected);
+
+  const many = context.signMany(timestamps);
+  assert.deepStrictEqual(many, expected);
+  for (const sig of many) {
+    assert.ok(Buffer.isBuffer(sig));
+    assert.strictEqual(sig.length, 64);
+  }
+});
@@ -0,0 +1,40 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+function filledWrapper() {
+  const { ContactsConfigWrapperNode } = addon();
+  const wrapper = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  for (let i = 0; i < 200; i++) wrapper.set(makeContact({ name: `contact ${i}` }));
+  return wrapper;
+}
+
+test('compact drops the push cache and snapshot, and keeps the data', () => {
+  const wrapper = filledWrapper();
+  const { data } = wrapper.push();
+  wrapper.snapshot();
+  const dump = wrapper.dump();
+  const usage = wrapper.memoryUsage();
+  assert.ok(usage.pushCache > 0 && usage.snapshot > 0);
+
+  const freed = wrapper.compact();
+  assert.strictEqual(typeof freed, 'number');
+  assert.ok(freed >= 0);
+  const compacted = wrapper.memoryUsage();
+  assert.strictEqual(compacted.pushCache, 0);
+  assert.strictEqual(compacted.snapshot, 0);
+  assert.deepStrictEqual(compacted.collections, usage.collections);
+
+  assert.deepStrictEqual(wrapper.dump(), dump);
+  assert.deepStrictEqual(wrapper.push().data, data);
+});
+
+test('compact with async resolves with the bytes freed', async () => {
+  const wrapper = filledWrapper();
+  wrapper.push();
+  const freed = wrapper.compact({ async: true });
+  assert.ok(freed instanceof Promise);
+  assert.ok((await freed) >= 0);
+  assert.strictEqual(wrapper.memoryUsage().pushCache, 0);
+});
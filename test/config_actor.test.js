@@ -0,0 +1,61 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+function contactsNamespace() {
+  const { ContactsConfigWrapperNode } = addon();
+  return new ContactsConfigWrapperNode(randomSecretKey(), null).storageNamespace();
+}
+
+test('contacts and the user name can be edited through the actor', async () => {
+  const { ConfigActorNode, ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const actor = new ConfigActorNode(key, {});
+  const contact = makeContact({ name: 'alice', approved: true });
+
+  // Not awaited: the calls still run in order
+  actor.setContact(contact);
+  actor.setUserName('bob');
+  assert.strictEqual((await actor.getContact(contact.id)).name, 'alice');
+  assert.strictEqual(await actor.getUserName(), 'bob');
+  assert.deepStrictEqual((await actor.getAllContacts()).map(c => c.id), [contact.id]);
+
+  const ns = contactsNamespace();
+  assert.strictEqual(await actor.needsPush(ns), true);
+  const wrapper = new ContactsConfigWrapperNode(key, await actor.dump(ns));
+  assert.strictEqual(wrapper.get(contact.id).approved, true);
+
+  assert.strictEqual(await actor.eraseContact(contact.id), true);
+  assert.strictEqual(await actor.eraseContact(contact.id), false);
+  assert.strictEqual(await actor.getContact(contact.id), null);
+  await actor.close();
+});
+
+test('a call with an invalid argument throws without being queued', async () => {
+  const { ConfigActorNode } = addon();
+  const actor = new ConfigActorNode(randomSecretKey(), {});
+  assert.throws(() => actor.setContact({}));
+  assert.throws(() => actor.getContact(1));
+  await actor.close();
+});
+
+test('close resolves once the queued calls ran, and no call can be made after', async () => {
+  const { ConfigActorNode } = addon();
+  const actor = new ConfigActorNode(randomSecretKey(), {});
+  const contact = makeContact({});
+  const set = actor.setContact(contact);
+  await actor.close();
+  await set;
+  assert.throws(() => actor.getContact(contact.id), /closed/);
+  assert.throws(() => actor.close(), /closed/);
+});
+
+test('an actor which is not closed does not keep the process alive', async () => {
+  const { ConfigActorNode } = addon();
+  let actor = new ConfigActorNode(randomSecretKey(), {});
+  await actor.setContact(makeContact({}));
+  actor = null;
+  // (the test runner would time out if the actor thread was still waited for)
+  if (global.gc) global.gc();
+});
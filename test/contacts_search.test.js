@@ -0,0 +1,33 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+test('search returns every matching contact, without holes', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+
+  contacts.set(makeContact({ name: 'Alice Smith' }));
+  const bob = makeContact({ name: 'Bob', nickname: 'smithy' });
+  contacts.set(bob);
+  contacts.set(makeContact({ name: 'Carol' }));
+
+  const found = contacts.search('smith', 10);
+  assert.strictEqual(found.length, 2);
+  for (const contact of found) assert.ok(contact && contact.id);
+
+  contacts.erase(bob.id);
+  const after = contacts.search('smith', 10);
+  assert.strictEqual(after.length, 1);
+  assert.strictEqual(after[0].name, 'Alice Smith');
+});
+
+test('search honours the limit and the case of neither side', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  for (let i = 0; i < 5; i++) contacts.set(makeContact({ name: `Dave ${i}` }));
+
+  assert.strictEqual(contacts.search('DAVE', 3).length, 3);
+  assert.strictEqual(contacts.search('dave', 10).length, 5);
+  assert.strictEqual(contacts.search('nobody', 10).length, 0);
+});
@@ -0,0 +1,66 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, randomSessionId, makeContact } = require('./helpers');
+
+const communityUrl = room => `https://example.org/${room}?public_key=${'00'.repeat(32)}`;
+
+function wrappers() {
+  const {
+    UserGroupsWrapperNode,
+    ContactsConfigWrapperNode,
+    ConvoInfoVolatileWrapperNode,
+    ConversationListWrapperNode,
+  } = addon();
+  const userGroups = new UserGroupsWrapperNode(randomSecretKey(), null);
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  const convoInfo = new ConvoInfoVolatileWrapperNode(randomSecretKey(), null);
+  const list = opts =>
+    ConversationListWrapperNode.conversationList(userGroups, contacts, convoInfo, opts);
+  return { userGroups, contacts, convoInfo, list };
+}
+
+test('conversations with only volatile info are listed for every kind', () => {
+  const { userGroups, contacts, convoInfo, list } = wrappers();
+
+  const contact = makeContact({ name: 'Frank' });
+  contacts.set(contact);
+  convoInfo.set1o1(contact.id, 10, false);
+  userGroups.setCommunityByFullUrl(communityUrl('joined'), 0);
+  convoInfo.setCommunityByFullUrl(communityUrl('Joined'), 20, true);
+
+  const request = randomSessionId();
+  convoInfo.set1o1(request, 30, true);
+  convoInfo.setCommunityByFullUrl(communityUrl('left'), 40, false);
+  const legacyGroup = randomSessionId();
+  convoInfo.setLegacyGroup(legacyGroup, 50, true);
+
+  const { conversations, total, unreadCount } = list({ sort: 'lastRead' });
+  assert.strictEqual(total, 5);
+  assert.strictEqual(unreadCount, 3);
+  assert.deepStrictEqual(
+    conversations.map(c => [c.type, c.lastRead]),
+    [
+      ['LegacyGroup', 50],
+      ['Community', 40],
+      ['1o1', 30],
+      ['Community', 20],
+      ['1o1', 10],
+    ]
+  );
+  const volatileOnly = conversations.filter(c => c.id === request || c.id === legacyGroup);
+  for (const c of volatileOnly) {
+    assert.strictEqual(c.name, null);
+    assert.strictEqual(c.priority, 0);
+  }
+});
+
+test('hidden conversations are only listed when asked for', () => {
+  const { contacts, list } = wrappers();
+  contacts.set(makeContact({ priority: -1 }));
+  contacts.set(makeContact({ priority: 1 }));
+
+  assert.strictEqual(list({}).total, 1);
+  assert.strictEqual(list({ includeHidden: true }).total, 2);
+  assert.strictEqual(list({ includeHidden: true }).pinnedCount, 1);
+});
@@ -0,0 +1,37 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact, pushedMessage } = require('./helpers');
+
+function external() {
+  return process.memoryUsage().external;
+}
+
+function filledDevice(key) {
+  const { ContactsConfigWrapperNode } = addon();
+  const device = new ContactsConfigWrapperNode(key, null);
+  for (let i = 0; i < 500; i++) device.set(makeContact({ name: `contact ${i}`.repeat(4) }));
+  return device;
+}
+
+test('a merge reports the native size of the wrapper to V8 right away', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const message = pushedMessage(filledDevice(key), 'h');
+
+  const before = external();
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+  wrapper.merge([message]);
+  assert.ok(external() - before >= wrapper.memoryUsage().total);
+});
+
+test('a wrapper loaded from a dump reports the size of the dump', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const dump = filledDevice(key).dump();
+
+  const before = external();
+  const wrapper = new ContactsConfigWrapperNode(key, dump);
+  assert.ok(external() - before >= dump.length);
+  assert.strictEqual(wrapper.getAll().length, 500);
+});
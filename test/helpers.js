@@ -0,0 +1,46 @@
+const crypto = require('crypto');
+const path = require('path');
+
+/** The addon, built for node with `yarn cmake-js` (or by `yarn install`) */
+function addon() {
+  return require(path.join(__dirname, '..'));
+}
+
+/** A random ed25519 secret key in libsodium's format: the 32 byte seed followed by the public key */
+function randomSecretKey() {
+  const { privateKey } = crypto.generateKeyPairSync('ed25519');
+  const jwk = privateKey.export({ format: 'jwk' });
+  return new Uint8Array(
+    Buffer.concat([Buffer.from(jwk.d, 'base64url'), Buffer.from(jwk.x, 'base64url')])
+  );
+}
+
+/** A random session id: 05 followed by 32 random bytes, in hex */
+function randomSessionId() {
+  return '05' + crypto.randomBytes(32).toString('hex');
+}
+
+/** A contact as taken by `ContactsConfigWrapperNode.set`, with the given fields overridden */
+function makeContact(fields) {
+  return {
+    id: randomSessionId(),
+    name: null,
+    nickname: null,
+    approved: false,
+    approvedMe: false,
+    blocked: false,
+    priority: 0,
+    createdAtSeconds: 0,
+    expirationMode: 'off',
+    expirationTimerSeconds: 0,
+    ...fields,
+  };
+}
+
+/** Pushes `wrapper` and returns its message as given to `merge`, under a made up `hash` */
+function pushedMessage(wrapper, hash) {
+  const { data } = wrapper.push();
+  return { hash, data };
+}
+
+module.exports = { addon, randomSecretKey, randomSessionId, makeContact, pushedMessage };
@@ -0,0 +1,64 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const crypto = require('crypto');
+
+const { addon, randomSecretKey, randomSessionId, makeContact } = require('./helpers');
+
+/** Each key must be a Buffer of its own, so that it gives no access to any other key */
+function assertStandaloneKeys(keys) {
+  for (const key of keys) {
+    assert.ok(Buffer.isBuffer(key));
+    assert.strictEqual(key.buffer.byteLength, key.length);
+  }
+}
+
+test('getAll and search return each profile picture key in its own buffer', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  for (let i = 0; i < 3; i++)
+    contacts.set(
+      makeContact({
+        name: `Erin ${i}`,
+        profilePicture: { url: `https://example.org/${i}`, key: crypto.randomBytes(32) },
+      })
+    );
+
+  const all = contacts.getAll();
+  assert.strictEqual(all.length, 3);
+  assertStandaloneKeys(all.map(c => c.profilePicture.key));
+  assertStandaloneKeys(contacts.search('erin', 10).map(c => c.profilePicture.key));
+  assert.ok(Buffer.isBuffer(contacts.get(all[0].id).profilePicture.key));
+});
+
+test('getAllLegacyGroups shares one buffer for the public keys only', () => {
+  const { UserGroupsWrapperNode } = addon();
+  const groups = new UserGroupsWrapperNode(randomSecretKey(), null);
+  const pubkeys = new Map();
+  for (let i = 0; i < 3; i++) {
+    const pubkeyHex = randomSessionId();
+    const encPubkey = crypto.randomBytes(32);
+    pubkeys.set(pubkeyHex, encPubkey);
+    groups.setLegacyGroup({
+      pubkeyHex,
+      name: `group ${i}`,
+      encPubkey,
+      encSeckey: crypto.randomBytes(32),
+      priority: 0,
+      members: [],
+      joinedAtSeconds: 0,
+    });
+  }
+
+  const all = groups.getAllLegacyGroups();
+  assert.strictEqual(all.length, 3);
+  assertStandaloneKeys(all.map(g => g.encSeckey));
+
+  const slab = all[0].encPubkey.buffer;
+  assert.strictEqual(slab.byteLength, 3 * 32);
+  for (const g of all) {
+    assert.ok(Buffer.isBuffer(g.encPubkey));
+    assert.strictEqual(g.encPubkey.buffer, slab);
+    assert.deepStrictEqual(g.encPubkey, pubkeys.get(g.pubkeyHex));
+  }
+  assert.ok(Buffer.isBuffer(groups.getLegacyGroup(all[0].pubkeyHex).encPubkey));
+});
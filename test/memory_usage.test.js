@@ -0,0 +1,49 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+function sum(usage) {
+  let total =
+    usage.pushCache + usage.seenHashes + usage.transactions + usage.snapshot + usage.ingestBuffer;
+  for (const c of Object.values(usage.collections)) total += c.bytes;
+  return total;
+}
+
+test('memoryUsage counts the entries of each collection, and what the wrapper keeps', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const wrapper = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  const empty = wrapper.memoryUsage();
+  assert.deepStrictEqual(empty.collections, { contacts: { entries: 0, bytes: 0 } });
+  assert.strictEqual(empty.total, sum(empty));
+
+  for (let i = 0; i < 10; i++) wrapper.set(makeContact({ name: `contact ${i}` }));
+  const filled = wrapper.memoryUsage();
+  assert.strictEqual(filled.collections.contacts.entries, 10);
+  assert.ok(filled.collections.contacts.bytes > 10 * 66);
+  assert.strictEqual(filled.pushCache, 0);
+
+  const { data } = wrapper.push();
+  assert.ok(wrapper.memoryUsage().pushCache >= data.length);
+  wrapper.snapshot();
+  const usage = wrapper.memoryUsage();
+  assert.ok(usage.snapshot > 0);
+  assert.strictEqual(usage.total, sum(usage));
+});
+
+test('memoryUsageAll adds up the wrappers alive, by collection name', () => {
+  const { ConfigBatchWrapperNode, ContactsConfigWrapperNode, UserGroupsWrapperNode } = addon();
+  const key = randomSecretKey();
+  const contacts = new ContactsConfigWrapperNode(key, null);
+  const userGroups = new UserGroupsWrapperNode(key, null);
+  for (let i = 0; i < 3; i++) contacts.set(makeContact({}));
+
+  // (other tests' wrappers may be alive too, until they are garbage collected)
+  const all = ConfigBatchWrapperNode.memoryUsageAll();
+  assert.ok(all.wrappers >= 2);
+  assert.ok(all.collections.contacts.entries >= 3);
+  assert.ok(all.collections.contacts.bytes >= contacts.memoryUsage().collections.contacts.bytes);
+  assert.ok('communities' in all.collections);
+  assert.ok('legacyGroups' in userGroups.memoryUsage().collections);
+  assert.strictEqual(all.total, sum(all));
+});
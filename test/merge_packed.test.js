@@ -0,0 +1,40 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact, pushedMessage } = require('./helpers');
+
+function pack(messages) {
+  const offsets = new Uint32Array(messages.length + 1);
+  messages.forEach((m, i) => (offsets[i + 1] = offsets[i] + m.data.length));
+  return [messages.map(m => m.hash), Buffer.concat(messages.map(m => m.data)), offsets];
+}
+
+test('mergePacked merges like merge', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const devices = [0, 1].map(() => new ContactsConfigWrapperNode(key, null));
+  const contacts = devices.map((device, i) => {
+    const contact = makeContact({ name: `device ${i}` });
+    device.set(contact);
+    return contact;
+  });
+  const messages = devices.map((device, i) => pushedMessage(device, `hash${i}`));
+
+  const packed = new ContactsConfigWrapperNode(key, null);
+  assert.deepStrictEqual(packed.mergePacked(...pack(messages)), ['hash0', 'hash1']);
+  const unpacked = new ContactsConfigWrapperNode(key, null);
+  unpacked.merge(messages);
+
+  for (const contact of contacts) assert.strictEqual(packed.get(contact.id).name, contact.name);
+  assert.deepStrictEqual(packed.getAll(), unpacked.getAll());
+});
+
+test('mergePacked rejects inconsistent offsets', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const wrapper = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  const data = Buffer.alloc(10);
+
+  assert.throws(() => wrapper.mergePacked(['a'], data, new Uint32Array([0])), /offsets/);
+  assert.throws(() => wrapper.mergePacked(['a'], data, new Uint32Array([0, 11])), /offsets/);
+  assert.throws(() => wrapper.mergePacked(['a', 'b'], data, new Uint32Array([0, 6, 4])), /offsets/);
+});
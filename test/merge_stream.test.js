@@ -0,0 +1,71 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const crypto = require('crypto');
+const { Readable } = require('node:stream');
+const { pipeline } = require('node:stream/promises');
+
+const { addon, randomSecretKey, makeContact, pushedMessage } = require('./helpers');
+
+function deviceMessages(key, count) {
+  const { ContactsConfigWrapperNode } = addon();
+  const messages = [];
+  const contacts = [];
+  for (let i = 0; i < count; i++) {
+    const device = new ContactsConfigWrapperNode(key, null);
+    const contact = makeContact({ name: `contact ${i}` });
+    device.set(contact);
+    contacts.push(contact);
+    messages.push(pushedMessage(device, `good${i}`));
+  }
+  return { messages, contacts };
+}
+
+test('a merge stream merges every message written to it, in batches', async () => {
+  const { ContactsConfigWrapperNode, createMergeStream } = addon();
+  const key = randomSecretKey();
+  const { messages, contacts } = deviceMessages(key, 50);
+  messages.push({ hash: 'garbage', data: crypto.randomBytes(200) });
+
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+  const stream = createMergeStream(wrapper, { maxBatchMessages: 8, highWaterBytes: 1 });
+  const batches = [];
+  stream.on('merged', hashes => batches.push(hashes));
+  await pipeline(Readable.from(messages), stream);
+
+  assert.ok(batches.length > 1);
+  assert.deepStrictEqual(batches.flat().sort(), contacts.map((_, i) => `good${i}`).sort());
+  for (const contact of contacts) assert.strictEqual(wrapper.get(contact.id).name, contact.name);
+  assert.strictEqual(wrapper.memoryUsage().ingestBuffer, 0);
+});
+
+test('ingest events count the messages which were not merged', async () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const { messages } = deviceMessages(key, 3);
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+
+  const events = [];
+  const done = new Promise(resolve =>
+    wrapper.ingestStart(event => {
+      events.push(event);
+      if (event.done) resolve();
+    })
+  );
+  for (const { hash, data } of messages) assert.strictEqual(wrapper.ingest(hash, data), true);
+  wrapper.ingest('garbage', crypto.randomBytes(200));
+  assert.strictEqual(wrapper.ingestEnd(), false);
+  await done;
+
+  assert.strictEqual(events.reduce((n, e) => n + e.merged.length, 0), 3);
+  assert.strictEqual(events.reduce((n, e) => n + e.undecryptable, 0), 1);
+});
+
+test('ingestStart checks its arguments', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const wrapper = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  assert.throws(() => wrapper.ingestStart(), /Invalid number of arguments/);
+  assert.throws(() => wrapper.ingestStart(() => {}, null, 1), /Invalid number of arguments/);
+  assert.throws(() => wrapper.ingestStart(1), /listener/);
+  wrapper.ingestStart(() => {});
+  assert.strictEqual(wrapper.ingestEnd(), true);
+});
@@ -0,0 +1,30 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const crypto = require('crypto');
+
+const { addon, randomSecretKey, makeContact, pushedMessage } = require('./helpers');
+
+test('merge drops only the messages it cannot decrypt or parse', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const messages = [];
+  const contacts = [];
+  for (let i = 0; i < 20; i++) {
+    const device = new ContactsConfigWrapperNode(key, null);
+    const contact = makeContact({ name: `contact ${i}` });
+    device.set(contact);
+    contacts.push(contact);
+    messages.push(pushedMessage(device, `good${i}`));
+  }
+  const stranger = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  stranger.set(makeContact({}));
+  messages.push(pushedMessage(stranger, 'otherKey'));
+  messages.push({ hash: 'garbage', data: crypto.randomBytes(200) });
+  messages.push({ hash: 'empty', data: new Uint8Array(0) });
+
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+  const merged = wrapper.merge(messages);
+  assert.deepStrictEqual(merged.sort(), contacts.map((_, i) => `good${i}`).sort());
+  assert.strictEqual(wrapper.mergeStats().lastUndecryptable, 3);
+  for (const contact of contacts) assert.strictEqual(wrapper.get(contact.id).name, contact.name);
+});
@@ -0,0 +1,106 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const crypto = require('crypto');
+const { setTimeout: sleep } = require('node:timers/promises');
+
+const { addon, randomSecretKey, randomSessionId } = require('./helpers');
+
+function groupKeys() {
+  const groupSecretKey = randomSecretKey();
+  return { groupEd25519Pubkey: groupSecretKey.slice(32), groupEd25519Secretkey: groupSecretKey };
+}
+
+function admin(keys) {
+  const { MetaGroupWrapperNode } = addon();
+  return new MetaGroupWrapperNode({ userEd25519Secretkey: randomSecretKey(), ...keys });
+}
+
+test('group changes update the status blocks, push cache and onChange listener', async () => {
+  const group = admin(groupKeys());
+  const changes = [];
+  group.onChange(change => changes.push(change));
+  const { groupInfo: infoStatus } = group.statusBlock();
+  const changeCount = infoStatus[2];
+
+  group.infoSet({ name: 'group' });
+  assert.strictEqual(infoStatus[0] & 1, 1);
+  assert.strictEqual(infoStatus[2], changeCount + 1);
+  const pushed = group.push().groupInfo;
+  assert.deepStrictEqual(group.push().groupInfo.data, pushed.data);
+
+  group.infoSet({ name: 'renamed' });
+  assert.notDeepStrictEqual(group.push().groupInfo.data, pushed.data);
+
+  group.membersAdd([{ pubkeyHex: randomSessionId(), name: 'member' }]);
+  await sleep(10);
+  const namespaces = new Set(changes.map(change => change.namespace));
+  const expected = new Set([pushed.namespace, group.push().groupMember.namespace]);
+  assert.deepStrictEqual(namespaces, expected);
+});
+
+test('merge keeps only the accepted key messages, and still merges the rest', () => {
+  const keys = groupKeys();
+  const first = admin(keys);
+  first.infoSet({ name: 'group' });
+  const pushed = first.push();
+
+  const second = admin(keys);
+  const merged = second.merge({
+    groupKeys: [
+      { hash: 'garbage', data: crypto.randomBytes(200), timestampMs: Date.now() },
+      { hash: 'keys', data: pushed.groupKeys.data, timestampMs: Date.now() },
+    ],
+    groupInfo: [{ hash: 'info', data: pushed.groupInfo.data }],
+  });
+
+  assert.deepStrictEqual(merged.groupKeys, ['keys']);
+  assert.deepStrictEqual(merged.groupInfo, ['info']);
+  assert.strictEqual(second.infoGet().name, 'group');
+});
+
+test('ConfigBatch pushes and confirms the info and members of a group', () => {
+  const { ConfigBatchWrapperNode } = addon();
+  const group = admin(groupKeys());
+  group.infoSet({ name: 'group' });
+  group.membersAdd([{ pubkeyHex: randomSessionId() }]);
+
+  const pushed = ConfigBatchWrapperNode.pushAll([group]);
+  assert.strictEqual(pushed.length, 2);
+  assert.throws(
+    () => ConfigBatchWrapperNode.confirmPushedAll([{ wrapper: group, seqno: 1, hash: 'h' }]),
+    /namespace/
+  );
+  ConfigBatchWrapperNode.confirmPushedAll(
+    pushed.map(({ namespace, seqno }) => ({
+      wrapper: group,
+      seqno,
+      hash: `h${namespace}`,
+      namespace,
+    }))
+  );
+  assert.strictEqual(group.push().groupInfo, null);
+  assert.strictEqual(group.push().groupMember, null);
+
+  assert.throws(() => ConfigBatchWrapperNode.transaction([group], () => {}), /transactions/);
+});
+
+test('autoPersist persists the combined dump', async () => {
+  const { MetaGroupWrapperNode } = addon();
+  const keys = groupKeys();
+  const userEd25519Secretkey = randomSecretKey();
+  const group = new MetaGroupWrapperNode({ userEd25519Secretkey, ...keys });
+  const dumps = [];
+  group.autoPersist({ sink: dump => dumps.push(dump), debounceMs: 0 });
+
+  group.infoSet({ name: 'group' });
+  assert.strictEqual(group.flushPersist(), true);
+  assert.strictEqual(group.needsDump(), false);
+  await sleep(100);
+
+  const loaded = new MetaGroupWrapperNode({
+    userEd25519Secretkey,
+    ...keys,
+    metaDumped: dumps[dumps.length - 1],
+  });
+  assert.strictEqual(loaded.infoGet().name, 'group');
+});
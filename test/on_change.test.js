@@ -0,0 +1,60 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const { setTimeout: sleep } = require('node:timers/promises');
+
+const { addon, randomSecretKey, makeContact, pushedMessage } = require('./helpers');
+
+/** A contacts wrapper with an `onChange` listener, and the changes it was given */
+function listenedWrapper(key = randomSecretKey()) {
+  const { ContactsConfigWrapperNode } = addon();
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+  const changes = [];
+  wrapper.onChange(change => changes.push(change));
+  return { wrapper, changes };
+}
+
+test('onChange reports the changes of a task once that task is done', async () => {
+  const { wrapper, changes } = listenedWrapper();
+  wrapper.set(makeContact({}));
+  wrapper.set(makeContact({}));
+  assert.deepStrictEqual(changes, []);
+
+  await sleep(20);
+  assert.deepStrictEqual(changes, [
+    {
+      namespace: wrapper.storageNamespace(),
+      kinds: ['local'],
+      needsPush: true,
+      needsDump: true,
+    },
+  ]);
+});
+
+test('onChange reports merges and confirmPushed', async () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const device = new ContactsConfigWrapperNode(key, null);
+  device.set(makeContact({}));
+  const message = pushedMessage(device, 'hash0');
+
+  const { wrapper, changes } = listenedWrapper(key);
+  wrapper.merge([message]);
+  await sleep(20);
+  assert.deepStrictEqual(changes[0].kinds, ['merge']);
+
+  wrapper.set(makeContact({}));
+  const { seqno } = wrapper.push();
+  wrapper.confirmPushed(seqno, 'hash1');
+  await sleep(20);
+  assert.deepStrictEqual(changes[1].kinds, ['local', 'confirmPushed']);
+  assert.strictEqual(changes[1].needsPush, false);
+});
+
+test('onChange(null) removes the listener', async () => {
+  const { wrapper, changes } = listenedWrapper();
+  wrapper.onChange(null);
+  wrapper.set(makeContact({}));
+  await sleep(20);
+  assert.deepStrictEqual(changes, []);
+  assert.throws(() => wrapper.onChange(42), /expected a function or null/);
+});
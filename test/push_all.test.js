@@ -0,0 +1,53 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+function userWrappers() {
+  const { ContactsConfigWrapperNode, UserGroupsWrapperNode, ConvoInfoVolatileWrapperNode } =
+    addon();
+  const key = randomSecretKey();
+  return {
+    contacts: new ContactsConfigWrapperNode(key, null),
+    userGroups: new UserGroupsWrapperNode(key, null),
+    convoInfo: new ConvoInfoVolatileWrapperNode(key, null),
+  };
+}
+
+test('pushAll pushes only the wrappers needing it, and confirmPushedAll confirms them', () => {
+  const { ConfigBatchWrapperNode } = addon();
+  const { contacts, userGroups, convoInfo } = userWrappers();
+  contacts.set(makeContact({}));
+  convoInfo.set1o1(makeContact({}).id, 1, true);
+
+  const wrappers = [contacts, userGroups, convoInfo, contacts];
+  const pushed = ConfigBatchWrapperNode.pushAll(wrappers);
+  assert.deepStrictEqual(
+    pushed.map(p => p.namespace),
+    [contacts.storageNamespace(), convoInfo.storageNamespace()]
+  );
+  assert.deepStrictEqual(pushed[0].data, contacts.push().data);
+
+  ConfigBatchWrapperNode.confirmPushedAll([
+    { wrapper: contacts, seqno: pushed[0].seqno, hash: 'h0' },
+    { wrapper: convoInfo, seqno: pushed[1].seqno, hash: 'h1' },
+  ]);
+  assert.strictEqual(contacts.needsPush(), false);
+  assert.strictEqual(convoInfo.needsPush(), false);
+  assert.deepStrictEqual(ConfigBatchWrapperNode.pushAll(wrappers), []);
+});
+
+test('confirmPushedAll confirms nothing if any entry is invalid', () => {
+  const { ConfigBatchWrapperNode } = addon();
+  const { contacts } = userWrappers();
+  contacts.set(makeContact({}));
+  const [pushed] = ConfigBatchWrapperNode.pushAll([contacts]);
+
+  assert.throws(() =>
+    ConfigBatchWrapperNode.confirmPushedAll([
+      { wrapper: contacts, seqno: pushed.seqno, hash: 'h0' },
+      { wrapper: {}, seqno: 1, hash: 'h1' },
+    ])
+  );
+  assert.strictEqual(contacts.needsPush(), true);
+});
@@ -0,0 +1,31 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+test('push returns its cached result until the config changes', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  contacts.set(makeContact({}));
+
+  const first = contacts.push();
+  assert.deepStrictEqual(contacts.push(), first);
+  assert.strictEqual(contacts.pushCacheHits(), 1);
+
+  contacts.set(makeContact({}));
+  assert.notDeepStrictEqual(contacts.push().data, first.data);
+  assert.strictEqual(contacts.pushCacheHits(), 1);
+});
+
+test('a setter throwing part way through does not leave a stale push cached', () => {
+  const { UserConfigWrapperNode } = addon();
+  const user = new UserConfigWrapperNode(randomSecretKey(), null);
+  user.setUserInfo('before', 0, null);
+  const before = user.push();
+
+  // The name is set before the invalid profile picture is rejected
+  assert.throws(() => user.setUserInfo('after', 0, 'not a profile picture'));
+  assert.strictEqual(user.getUserInfo().name, 'after');
+  const after = user.push();
+  assert.notDeepStrictEqual(after.data, before.data);
+});
@@ -0,0 +1,28 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+test('estimatePushSize bounds the size of the next push, and is exact once pushed', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const wrapper = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  for (let i = 0; i < 200; i++) wrapper.set(makeContact({ name: `contact ${i}` }));
+
+  const estimate = wrapper.estimatePushSize();
+  assert.strictEqual(estimate.exact, false);
+  const { data } = wrapper.push();
+  assert.ok(estimate.bytes >= data.length);
+  assert.deepStrictEqual(wrapper.estimatePushSize(), { bytes: data.length, exact: true });
+});
+
+test('remainingCapacity is measured against the given limit, if any', () => {
+  const { ContactsConfigWrapperNode, CONSTANTS } = addon();
+  const wrapper = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  wrapper.set(makeContact({}));
+  const { bytes } = wrapper.estimatePushSize();
+
+  assert.strictEqual(wrapper.remainingCapacity(), CONSTANTS.CONFIG_MAX_PUSH_SIZE - bytes);
+  assert.strictEqual(wrapper.remainingCapacity(bytes + 10), 10);
+  assert.strictEqual(wrapper.remainingCapacity(1), 0);
+  assert.throws(() => wrapper.remainingCapacity(-1), /maxBytes/);
+});
@@ -0,0 +1,47 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+function contactsWithPriorities(priorities) {
+  const { ContactsConfigWrapperNode } = addon();
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  for (const priority of priorities) contacts.set(makeContact({ name: `p${priority}`, priority }));
+  return contacts;
+}
+
+test('query filters natively on integer fields', () => {
+  const contacts = contactsWithPriorities([0, 1, 2]);
+
+  assert.strictEqual(contacts.query({ priority: 1 }, null).length, 1);
+  assert.strictEqual(contacts.query({ priority: { gte: 1 } }, null).length, 2);
+  assert.strictEqual(contacts.query({ priority: { gt: 0, lt: 2 } }, ['name'])[0].name, 'p1');
+});
+
+test('query rejects fractional numbers rather than truncating them', () => {
+  const contacts = contactsWithPriorities([1]);
+
+  assert.throws(() => contacts.query({ priority: 1.5 }, null), /integers/);
+  assert.throws(() => contacts.query({ priority: { lt: 1.5 } }, null), /integers/);
+  assert.throws(() => contacts.query({ priority: Infinity }, null), /integers/);
+});
+
+test('query returns the same objects as the getters', () => {
+  const contacts = contactsWithPriorities([0, 1]);
+  const { UserGroupsWrapperNode, ConvoInfoVolatileWrapperNode } = addon();
+
+  assert.deepStrictEqual(contacts.query(null, null), contacts.getAll());
+  const projected = contacts.query(null, ['id', 'priority']);
+  for (const contact of projected) {
+    const full = contacts.get(contact.id);
+    assert.deepStrictEqual(contact, { id: full.id, priority: full.priority });
+  }
+
+  const groups = new UserGroupsWrapperNode(randomSecretKey(), null);
+  groups.setCommunityByFullUrl('https://example.org/room?public_key=' + '00'.repeat(32), 2);
+  assert.deepStrictEqual(groups.queryCommunities(null, null), groups.getAllCommunities());
+
+  const convos = new ConvoInfoVolatileWrapperNode(randomSecretKey(), null);
+  convos.set1o1(makeContact({}).id, 1234, true);
+  assert.deepStrictEqual(convos.query1o1(null, null), convos.getAll1o1());
+});
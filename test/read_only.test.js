@@ -0,0 +1,71 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const path = require('node:path');
+const { Worker } = require('node:worker_threads');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+const PUBKEY = 'ab'.repeat(32);
+
+test('a contacts export reads like the wrapper, and opens again by its handle', () => {
+  const { ContactsConfigWrapperNode, ContactsReadOnlyNode } = addon();
+  const contacts = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  const contact = makeContact({ name: 'alice' });
+  contacts.set(contact);
+  contacts.set(makeContact({}));
+
+  const exported = contacts.exportReadOnly();
+  contacts.erase(contact.id);
+  assert.strictEqual(exported.get(contact.id).name, 'alice');
+  assert.strictEqual(exported.getAll().length, 2);
+
+  const opened = new ContactsReadOnlyNode(exported.handle());
+  assert.deepStrictEqual(opened.getAll(), exported.getAll());
+  assert.strictEqual(opened.get(makeContact({}).id), null);
+  assert.throws(() => new ContactsReadOnlyNode(1e9), /Unknown read-only snapshot/);
+});
+
+test('a user groups export finds communities the way libsession does', () => {
+  const { UserGroupsWrapperNode, UserGroupsReadOnlyNode } = addon();
+  const userGroups = new UserGroupsWrapperNode(randomSecretKey(), null);
+  userGroups.setCommunityByFullUrl(`https://example.org/SomeRoom?public_key=${PUBKEY}`, 0);
+  userGroups.setCommunityByFullUrl(`https://example.org/other?public_key=${PUBKEY}`, 2);
+
+  const exported = userGroups.exportReadOnly();
+  assert.ok(exported instanceof UserGroupsReadOnlyNode);
+  assert.deepStrictEqual(
+    exported.getCommunityByFullUrl('https://example.org/someroom'),
+    userGroups.getCommunityByFullUrl('https://example.org/someroom')
+  );
+  assert.strictEqual(exported.getCommunityByFullUrl('https://example.org/other').priority, 2);
+  assert.strictEqual(exported.getCommunityByFullUrl('https://example.org/none'), null);
+  assert.deepStrictEqual(exported.getAllCommunities(), userGroups.getAllCommunities());
+  assert.deepStrictEqual(exported.getAllLegacyGroups(), []);
+});
+
+test('a worker opens an export by its handle', async () => {
+  const { ConvoInfoVolatileWrapperNode } = addon();
+  const convoInfo = new ConvoInfoVolatileWrapperNode(randomSecretKey(), null);
+  const { id } = makeContact({});
+  convoInfo.set1o1(id, 1234, true);
+  const exported = convoInfo.exportReadOnly();
+
+  const worker = new Worker(
+    `
+    const { parentPort, workerData } = require('node:worker_threads');
+    const { ConvoInfoVolatileReadOnlyNode } = require(workerData.addon);
+    const convos = new ConvoInfoVolatileReadOnlyNode(workerData.handle);
+    parentPort.postMessage(convos.get1o1(workerData.id));
+    `,
+    {
+      eval: true,
+      workerData: { addon: path.join(__dirname, '..'), handle: exported.handle(), id },
+    }
+  );
+  const convo = await new Promise((resolve, reject) =>
+    worker.once('message', resolve).once('error', reject)
+  );
+  await worker.terminate();
+  assert.strictEqual(convo.lastRead, 1234);
+  assert.strictEqual(convo.unread, true);
+});
@@ -0,0 +1,74 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact, pushedMessage } = require('./helpers');
+
+function pushedContact(key, hash) {
+  const { ContactsConfigWrapperNode } = addon();
+  const device = new ContactsConfigWrapperNode(key, null);
+  device.set(makeContact({ name: hash }));
+  return pushedMessage(device, hash);
+}
+
+test('merge skips the messages it already merged, still reporting them', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const message = pushedContact(key, 'hash0');
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+
+  assert.deepStrictEqual(wrapper.merge([message]), ['hash0']);
+  assert.strictEqual(wrapper.mergeStats().lastSkipped, 0);
+
+  const other = pushedContact(key, 'hash1');
+  assert.deepStrictEqual(wrapper.merge([message, other]), ['hash0', 'hash1']);
+  const stats = wrapper.mergeStats();
+  assert.strictEqual(stats.lastSkipped, 1);
+  assert.strictEqual(stats.totalSkipped, 1);
+  assert.strictEqual(wrapper.getAll().length, 2);
+});
+
+test('the hashes of our own pushes are skipped too', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const wrapper = new ContactsConfigWrapperNode(randomSecretKey(), null);
+  wrapper.set(makeContact({}));
+  const { data, seqno } = wrapper.push();
+  wrapper.confirmPushed(seqno, 'ours');
+
+  assert.deepStrictEqual(wrapper.merge([{ hash: 'ours', data }]), ['ours']);
+  assert.strictEqual(wrapper.mergeStats().lastSkipped, 1);
+});
+
+test('seen hashes survive a reload through seenHashes/addSeenHashes', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const message = pushedContact(key, 'hash0');
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+  wrapper.merge([message]);
+
+  const reloaded = new ContactsConfigWrapperNode(key, wrapper.dump());
+  reloaded.addSeenHashes(wrapper.seenHashes());
+  assert.ok(reloaded.seenHashes().includes('hash0'));
+  reloaded.merge([message]);
+  assert.strictEqual(reloaded.mergeStats().lastSkipped, 1);
+});
+
+test('compact keeps the seen hashes usable once the oldest were evicted', () => {
+  const { ContactsConfigWrapperNode } = addon();
+  const key = randomSecretKey();
+  const wrapper = new ContactsConfigWrapperNode(key, null);
+  // Short enough to be stored inline in the strings, past the 10,000 hashes kept
+  const hashes = Array.from({ length: 12000 }, (_, i) => `h${i}`);
+  wrapper.addSeenHashes(hashes);
+  wrapper.compact();
+
+  assert.deepStrictEqual(wrapper.seenHashes(), hashes.slice(-10000));
+  assert.strictEqual(wrapper.mergeStats().seenHashes, 10000);
+  const message = pushedContact(key, 'h11999');
+  assert.deepStrictEqual(wrapper.merge([message]), ['h11999']);
+  assert.strictEqual(wrapper.mergeStats().lastSkipped, 1);
+
+  const evicted = pushedContact(key, 'h0');
+  assert.deepStrictEqual(wrapper.merge([evicted]), ['h0']);
+  assert.strictEqual(wrapper.mergeStats().lastSkipped, 0);
+  assert.ok(wrapper.seenHashes().includes('h0'));
+});
@@ -0,0 +1,50 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact, pushedMessage } = require('./helpers');
+
+function contactsWrapper(key = randomSecretKey()) {
+  const { ContactsConfigWrapperNode } = addon();
+  return new ContactsConfigWrapperNode(key, null);
+}
+
+test('restore reverts local changes, keeping the seen hashes', () => {
+  const contacts = contactsWrapper();
+  contacts.set(makeContact({ name: 'kept' }));
+  contacts.addSeenHashes(['h1', 'h2']);
+  const snapshot = contacts.snapshot();
+  assert.strictEqual(contacts.restore(snapshot), false);
+
+  contacts.set(makeContact({ name: 'dropped' }));
+  assert.strictEqual(contacts.restore(snapshot), true);
+  assert.deepStrictEqual(contacts.getAll().map(c => c.name), ['kept']);
+  assert.ok(contacts.seenHashes().includes('h1'));
+  assert.ok(contacts.seenHashes().includes('h2'));
+});
+
+test('restore refuses to revert a merge or a confirmed push', () => {
+  const key = randomSecretKey();
+  const device = contactsWrapper(key);
+  device.set(makeContact({}));
+  const message = pushedMessage(device, 'hash0');
+
+  const contacts = contactsWrapper(key);
+  let snapshot = contacts.snapshot();
+  contacts.merge([message]);
+  assert.throws(() => contacts.restore(snapshot), /merged messages or confirmed a push/);
+  assert.strictEqual(contacts.getAll().length, 1);
+
+  snapshot = contacts.snapshot();
+  contacts.set(makeContact({}));
+  const { seqno } = contacts.push();
+  contacts.confirmPushed(seqno, 'hash1');
+  assert.throws(() => contacts.restore(snapshot), /merged messages or confirmed a push/);
+  assert.strictEqual(contacts.needsPush(), false);
+});
+
+test('restore rejects snapshots of other wrappers', () => {
+  const contacts = contactsWrapper();
+  const other = contactsWrapper();
+  assert.throws(() => contacts.restore(other.snapshot()), /another wrapper/);
+  assert.throws(() => contacts.restore({}), /expected a snapshot/);
+});
@@ -0,0 +1,56 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+const FLAGS = 0;
+const SEQNO = 1;
+const MUTATIONS = 2;
+const NEEDS_PUSH = 1;
+const NEEDS_DUMP = 2;
+
+function contactsWrapper() {
+  const { ContactsConfigWrapperNode } = addon();
+  return new ContactsConfigWrapperNode(randomSecretKey(), null);
+}
+
+test('statusBlock follows changes, pushes and confirms', () => {
+  const contacts = contactsWrapper();
+  const status = contacts.statusBlock();
+  assert.strictEqual(contacts.statusBlock(), status);
+  assert.strictEqual(status[FLAGS] & NEEDS_PUSH, 0);
+
+  contacts.set(makeContact({}));
+  assert.strictEqual(status[MUTATIONS], 1);
+  assert.strictEqual(status[FLAGS], NEEDS_PUSH | NEEDS_DUMP);
+
+  const { seqno } = contacts.push();
+  assert.strictEqual(status[SEQNO], seqno);
+
+  contacts.confirmPushed(seqno, 'hash1');
+  contacts.dump();
+  assert.strictEqual(status[FLAGS], 0);
+});
+
+test('statusBlock is updated after pushAll', () => {
+  const { ConfigBatchWrapperNode } = addon();
+  const contacts = contactsWrapper();
+  const status = contacts.statusBlock();
+  contacts.set(makeContact({}));
+
+  const [pushed] = ConfigBatchWrapperNode.pushAll([contacts]);
+  assert.strictEqual(status[SEQNO], pushed.seqno);
+});
+
+test('statusBlock returns a new array once the old one is transferred', () => {
+  const contacts = contactsWrapper();
+  const status = contacts.statusBlock();
+  structuredClone(status.buffer, { transfer: [status.buffer] });
+  assert.strictEqual(status.length, 0);
+
+  contacts.set(makeContact({}));
+  const fresh = contacts.statusBlock();
+  assert.notStrictEqual(fresh, status);
+  assert.strictEqual(fresh[MUTATIONS], 1);
+  assert.strictEqual(fresh[FLAGS] & NEEDS_PUSH, NEEDS_PUSH);
+});
@@ -0,0 +1,80 @@
+const test = require('node:test');
+const assert = require('node:assert');
+
+const { addon, randomSecretKey, makeContact } = require('./helpers');
+
+const SEQNO = 1;
+
+function contactsWrapper() {
+  const { ContactsConfigWrapperNode } = addon();
+  return new ContactsConfigWrapperNode(randomSecretKey(), null);
+}
+
+test('a throwing transaction reverts the data and the last seqno', () => {
+  const { ConfigBatchWrapperNode } = addon();
+  const contacts = contactsWrapper();
+  const kept = makeContact({ name: 'kept' });
+  contacts.set(kept);
+  const status = contacts.statusBlock();
+  const seqno = status[SEQNO];
+
+  assert.throws(
+    () =>
+      ConfigBatchWrapperNode.transaction([contacts], () => {
+        contacts.set(makeContact({ name: 'dropped' }));
+        contacts.push();
+        throw new Error('oops');
+      }),
+    /oops/
+  );
+  assert.deepStrictEqual(contacts.getAll().map(c => c.name), ['kept']);
+  assert.strictEqual(status[SEQNO], seqno);
+
+  // The wrapper still works after the rollback
+  contacts.set(makeContact({}));
+  assert.strictEqual(contacts.getAll().length, 2);
+});
+
+test('a transaction returning a promise is reverted', () => {
+  const { ConfigBatchWrapperNode } = addon();
+  const contacts = contactsWrapper();
+
+  assert.throws(
+    () =>
+      ConfigBatchWrapperNode.transaction([contacts], async () => {
+        contacts.set(makeContact({}));
+      }),
+    TypeError
+  );
+  assert.deepStrictEqual(contacts.getAll(), []);
+  assert.throws(
+    () => ConfigBatchWrapperNode.transaction([contacts], () => ({ then: () => {} })),
+    /must be synchronous/
+  );
+});
+
+test('a transaction returns the result of its function', () => {
+  const { ConfigBatchWrapperNode } = addon();
+  const contacts = contactsWrapper();
+  const result = ConfigBatchWrapperNode.transaction([contacts], () => {
+    contacts.set(makeContact({}));
+    return 42;
+  });
+  assert.strictEqual(result, 42);
+  assert.strictEqual(contacts.getAll().length, 1);
+});
+
+test('compact keeps the data and the wrapper usable', () => {
+  const contacts = contactsWrapper();
+  const ids = [];
+  for (let i = 0; i < 20; i++) {
+    const contact = makeContact({});
+    ids.push(contact.id);
+    contacts.set(contact);
+  }
+  for (const id of ids.slice(1)) contacts.erase(id);
+  contacts.compact();
+  assert.deepStrictEqual(contacts.getAll().map(c => c.id), [ids[0]]);
+  contacts.set(makeContact({}));
+  assert.strictEqual(contacts.getAll().length, 2);
+});
@@ -0,0 +1,39 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const crypto = require('crypto');
+
+const { addon } = require('./helpers');
+
+function signed(message) {
+  const { privateKey, publicKey } = crypto.generateKeyPairSync('ed25519');
+  const pubkey = Buffer.from(publicKey.export({ format: 'jwk' }).x, 'base64url');
+  return { pubkey, message, signature: crypto.sign(null, message, privateKey) };
+}
+
+const isSet = (bitmap, i) => (bitmap[Math.floor(i / 8)] & (1 << i % 8)) !== 0;
+
+test('verifyMany accepts raw and hex pubkeys, with an ed25519 prefix or none', async () => {
+  const { VerificationWrapperNode } = addon();
+  const item = signed(Buffer.from('hello'));
+  const hex = item.pubkey.toString('hex');
+  const items = [
+    item,
+    { ...item, pubkey: hex },
+    ...['00', '07', '15', '25'].map(prefix => ({ ...item, pubkey: prefix + hex })),
+    { ...item, message: Buffer.from('tampered') },
+  ];
+
+  const bitmap = VerificationWrapperNode.verifyMany(items);
+  for (let i = 0; i < items.length - 1; i++) assert.ok(isSet(bitmap, i), `item ${i}`);
+  assert.ok(!isSet(bitmap, items.length - 1));
+  assert.deepStrictEqual(await VerificationWrapperNode.verifyManyAsync(items), bitmap);
+});
+
+test('verifyMany rejects any other prefix', () => {
+  const { VerificationWrapperNode } = addon();
+  const item = signed(Buffer.from('hello'));
+  for (const prefix of ['05', '03', 'ff']) {
+    const pubkey = prefix + item.pubkey.toString('hex');
+    assert.throws(() => VerificationWrapperNode.verifyMany([{ ...item, pubkey }]), /prefix/);
+  }
+});
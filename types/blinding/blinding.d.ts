@@ -27,6 +27,50 @@ declare module 'libsession_util_nodejs' {
     public static blindVersionSign: BlindingWrapper['blindVersionSign'];
   }
 
+  /**
+   * Caches the blinded version keypair derived from `ed25519SecretKey`, so it is only derived once.
+   * To be used inside the web worker only (calls are synchronous and won't work asynchrously)
+   */
+  export class BlindingContextNode {
+    constructor(opts: {
+      /**
+       * len 64: ed25519 secretKey with pubkey
+       */
+      ed25519SecretKey: Uint8Array;
+    });
+    /** same as `BlindingWrapperNode.blindVersionPubkey` for the key given on construction */
+    public blindVersionPubkey: () => string;
+    /** same as `BlindingWrapperNode.blindVersionSign` for the key given on construction */
+    public blindVersionSign: (sigTimestampSeconds: number) => Uint8Array;
+    /** signs each of the timestamps, in a single call */
+    public signMany: (sigTimestampsSeconds: Array<number>) => Array<Uint8Array>;
+  }
+
+  export type BlindedIdLookupResult = {
+    /** the 05-prefixed session id of the contact */
+    sessionId: string;
+    /** the pubkey of the community server the blinded id is for */
+    serverPubkeyHex: string;
+  };
+
+  /**
+   * Reverse index from the blinded ids (15 and 25 prefixed) of our contacts on each of our communities' servers, to their session ids.
+   * It follows the changes of the wrappers it was constructed with: each call first brings it up to date with them if needed.
+   * To be used inside the web worker only (calls are synchronous and won't work asynchrously)
+   */
+  export class BlindedIdIndexNode {
+    constructor(userGroups: UserGroupsWrapperNode, contacts: ContactsConfigWrapperNode);
+    /**
+     * Updates the index now if the contacts or communities changed, rather than on the next lookup.
+     * Only the blinded ids of new (contact, server) pairs are computed.
+     * @returns the number of (contact, server) pairs which had to be computed
+     */
+    public refresh: () => number;
+    public lookupBlinded: (blindedId: string) => BlindedIdLookupResult | null;
+    /** the number of blinded ids indexed */
+    public size: () => number;
+  }
+
   /**
    * Those actions are used internally for the web worker communication.
    * You should never need to import them in Session directly
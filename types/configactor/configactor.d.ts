@@ -0,0 +1,45 @@
+/// <reference path="../../shared.d.ts" />
+/// <reference path="../configbatch/configbatch.d.ts" />
+/// <reference path="../../user/contacts.d.ts" />
+
+declare module 'libsession_util_nodejs' {
+  /** The dumps to load the configs of a `ConfigActorNode` from (a config without one starts empty) */
+  export type ConfigActorDumps = {
+    userProfile?: Uint8Array | null;
+    contacts?: Uint8Array | null;
+    userGroups?: Uint8Array | null;
+    convoInfoVolatile?: Uint8Array | null;
+  };
+
+  /**
+   * Owns the user configs of an account on a dedicated native thread: every call is queued and run there, in order, and
+   * none of them blocks the calling thread. Configs are addressed by their storage namespace.
+   * The user name and the contacts can be read and edited through the actor; for anything else, `dump` the config to
+   * load it in a wrapper instead.
+   * An actor garbage collected without being closed stops its thread once the calls already made are done, without
+   * waiting for it.
+   */
+  export class ConfigActorNode {
+    constructor(secretKey: Uint8Array, dumps: ConfigActorDumps);
+    public needsPush: (namespace: number) => Promise<boolean>;
+    public needsDump: (namespace: number) => Promise<boolean>;
+    public push: (namespace: number) => Promise<PushConfigResult>;
+    /** Pushes all the configs which need it. */
+    public pushAll: () => Promise<Array<PushAllResult>>;
+    public dump: (namespace: number) => Promise<Uint8Array>;
+    public confirmPushed: (namespace: number, seqno: number, hash: string) => Promise<void>;
+    /** Resolves with the hashes of the messages which were merged successfully */
+    public merge: (namespace: number, toMerge: Array<MergeSingle>) => Promise<Array<string>>;
+    public getUserName: () => Promise<string | null>;
+    /** Truncated like `UserConfigWrapperNode.setUserInfo`; null clears the name. */
+    public setUserName: (name: string | null) => Promise<void>;
+    public getContact: (pubkeyHex: string) => Promise<ContactInfo | null>;
+    public getAllContacts: () => Promise<Array<ContactInfo>>;
+    /** Same as `ContactsConfigWrapperNode.set` */
+    public setContact: (contact: ContactInfoSet) => Promise<void>;
+    /** Resolves with whether the contact existed */
+    public eraseContact: (pubkeyHex: string) => Promise<boolean>;
+    /** Stops the thread once the calls already made are done (which is when this resolves); no call can be made after. */
+    public close: () => Promise<void>;
+  }
+}
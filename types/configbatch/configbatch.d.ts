@@ -0,0 +1,49 @@
+/// <reference path="../../shared.d.ts" />
+/// <reference path="../metagroup/metagroup.d.ts" />
+
+declare module 'libsession_util_nodejs' {
+  export type PushAllResult = PushConfigResult & {
+    /** the storage namespace of the wrapper this was pushed from */
+    namespace: number;
+  };
+
+  export type ConfirmPushedSingle = {
+    wrapper: BaseConfigWrapperNode | MetaGroupWrapperNode;
+    seqno: number;
+    hash: string;
+    /** Required for a MetaGroupWrapperNode, to tell its Info from its Members: as returned by `pushAll` */
+    namespace?: number;
+  };
+
+  /**
+   * To be used inside the web worker only (calls are synchronous and won't work asynchrously)
+   */
+  export class ConfigBatchWrapperNode {
+    /**
+     * Pushes all the given wrappers which need it, encrypting them in parallel.
+     * Wrappers which do not need a push are not part of the result. A MetaGroupWrapperNode pushes its Info and Members
+     * (but not its Keys, which have no seqno: use its own `push` for those).
+     */
+    public static pushAll: (
+      wrappers: Array<BaseConfigWrapperNode | MetaGroupWrapperNode>
+    ) => Array<PushAllResult>;
+    /**
+     * Same as calling `confirmPushed` on each of the wrappers. Nothing is confirmed if any of the entries is invalid.
+     */
+    public static confirmPushedAll: (confirmations: Array<ConfirmPushedSingle>) => void;
+    /**
+     * Calls `fn` and returns its result. The changes it makes to the given wrappers only trigger their `onChange` listener and `autoPersist` once, when it returns.
+     * If `fn` throws, the wrappers are reverted to how they were before the call and the error is rethrown.
+     * `fn` must be synchronous: if it returns a promise (or any thenable), the wrappers are reverted and a TypeError is thrown.
+     * Transactions can be nested. A MetaGroupWrapperNode can't be part of a transaction, as its configs can't be reverted.
+     * Each transaction takes a full dump of every wrapper given (to revert to), so it costs O(size of those configs) even when
+     * `fn` changes nothing.
+     */
+    public static transaction: <T>(wrappers: Array<BaseConfigWrapperNode>, fn: () => T) => T;
+    /**
+     * The sum of `memoryUsage()` over all the wrappers alive in this thread (collections of the same name are added up),
+     * and how many wrappers there are (the Info and Members of a MetaGroupWrapperNode count as two).
+     */
+    public static memoryUsageAll: () => ConfigMemoryUsage & { wrappers: number };
+  }
+}
@@ -0,0 +1,56 @@
+/// <reference path="../../shared.d.ts" />
+/// <reference path="../../user/index.d.ts" />
+
+declare module 'libsession_util_nodejs' {
+  export type ConversationListItem = {
+    type: ConvoVolatileType;
+    /** pubkeyHex for 1o1s and legacy groups, fullUrlWithPubkey for communities */
+    id: string;
+    /** nickname or name for 1o1s, room for communities, null if unset */
+    name: string | null;
+    priority: number;
+    unread: boolean;
+    lastRead: number;
+  };
+
+  export type ConversationListOptions = {
+    /**
+     * 'priority' (the default): pinned conversations first, then by lastRead.
+     * 'lastRead': most recently read first.
+     */
+    sort?: 'priority' | 'lastRead';
+    /** 0 or undefined means no limit */
+    limit?: number;
+    offset?: number;
+    /** hidden conversations (priority < 0) are not included unless this is set */
+    includeHidden?: boolean;
+  };
+
+  export type ConversationListResult = {
+    /** only the requested page */
+    conversations: Array<ConversationListItem>;
+    /** the number of conversations, across all pages */
+    total: number;
+    /** the number of conversations marked as unread, across all pages */
+    unreadCount: number;
+    /** the number of pinned conversations, across all pages */
+    pinnedCount: number;
+  };
+
+  /**
+   * To be used inside the web worker only (calls are synchronous and won't work asynchrously)
+   */
+  export class ConversationListWrapperNode {
+    /**
+     * Joins the contacts, user groups and convo info volatile data into the list of conversations, sorted and paginated natively.
+     * Every kind of conversation is listed the same way: the 1o1s of the contacts and the communities and legacy groups of the user groups,
+     * plus the conversations of each kind which only have convo info volatile data (with a null name and a priority of 0).
+     */
+    public static conversationList: (
+      userGroups: UserGroupsWrapperNode,
+      contacts: ContactsConfigWrapperNode,
+      convoInfo: ConvoInfoVolatileWrapperNode,
+      opts: ConversationListOptions
+    ) => ConversationListResult;
+  }
+}
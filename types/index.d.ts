@@ -1 +1,6 @@
 /// <reference path="./blinding/index.d.ts" />
+/// <reference path="./configactor/index.d.ts" />
+/// <reference path="./configbatch/index.d.ts" />
+/// <reference path="./conversationlist/index.d.ts" />
+/// <reference path="./metagroup/index.d.ts" />
+/// <reference path="./verification/index.d.ts" />
@@ -0,0 +1,2 @@
+/// <reference path="../../shared.d.ts" />
+/// <reference path="./metagroup.d.ts" />
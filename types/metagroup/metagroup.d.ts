@@ -0,0 +1,127 @@
+/// <reference path="../../shared.d.ts" />
+
+declare module 'libsession_util_nodejs' {
+  export type MetaGroupWrapperConstructor = {
+    userEd25519Secretkey: Uint8Array;
+    groupEd25519Pubkey: Uint8Array;
+    /** Only given to admins */
+    groupEd25519Secretkey?: Uint8Array | null;
+    /** As returned by `dump` */
+    metaDumped?: Uint8Array | null;
+  };
+
+  export type GroupInfoGet = {
+    name: string | null;
+    createdAtSeconds: number | null;
+    expirySeconds: number | null;
+    deleteBeforeSeconds: number | null;
+    deleteAttachBeforeSeconds: number | null;
+    isDestroyed: boolean;
+    profilePicture: ProfilePicture;
+  };
+
+  /** Only the fields given are changed */
+  export type GroupInfoSet = Partial<Omit<GroupInfoGet, 'isDestroyed'>>;
+
+  export type GroupMemberGet = {
+    pubkeyHex: string;
+    name: string | null;
+    profilePicture: ProfilePicture;
+    admin: boolean;
+    invitePending: boolean;
+    inviteFailed: boolean;
+    promotionPending: boolean;
+    promotionFailed: boolean;
+    promoted: boolean;
+  };
+
+  export type GroupMemberAdd = {
+    pubkeyHex: string;
+    name?: string | null;
+    profilePicture?: ProfilePicture;
+  };
+
+  export type MetaGroupPushResult = {
+    groupInfo: (PushConfigResult & { namespace: number }) | null;
+    groupMember: (PushConfigResult & { namespace: number }) | null;
+    /** The keys have no seqno: they are pending until their message comes back through `merge` */
+    groupKeys: { data: Uint8Array; namespace: number } | null;
+  };
+
+  export type MetaGroupConfirmPushed = {
+    groupInfo?: { seqno: number; hash: string } | null;
+    groupMember?: { seqno: number; hash: string } | null;
+  };
+
+  export type MetaGroupMerge = {
+    groupInfo?: Array<MergeSingle> | null;
+    groupMember?: Array<MergeSingle> | null;
+    groupKeys?: Array<MergeSingle & { timestampMs: number }> | null;
+  };
+
+  /** The hashes merged successfully, per namespace. Key messages which libsession rejected or failed to load are left out. */
+  export type MetaGroupMergeResult = {
+    groupInfo: Array<string>;
+    groupMember: Array<string>;
+    groupKeys: Array<string>;
+  };
+
+  export type MetaGroupStatusBlock = {
+    groupInfo: Int32Array;
+    groupMember: Int32Array;
+  };
+
+  /**
+   * The Info, Members and Keys configs of a closed group, handled together: each of the combined methods spans the three
+   * namespaces. The member methods take arrays, so that large groups don't need one call per member.
+   * The Info and Members can also be given to `ConfigBatchWrapperNode.pushAll`, `confirmPushedAll` and `memoryUsageAll`
+   * (where they count as two wrappers), but not to `transaction`.
+   */
+  export class MetaGroupWrapperNode {
+    constructor(options: MetaGroupWrapperConstructor);
+
+    // combined methods
+    public needsPush: () => boolean;
+    public needsDump: () => boolean;
+    public push: () => MetaGroupPushResult;
+    /** A single dump of the three configs, to give back as `metaDumped` */
+    public dump: () => Uint8Array;
+    public confirmPushed: (pushed: MetaGroupConfirmPushed) => void;
+    /** The keys are loaded first, as the info and members messages may need them */
+    public merge: (toMerge: MetaGroupMerge) => MetaGroupMergeResult;
+    /** The status blocks of the Info and Members, as `statusBlock` of the other wrappers */
+    public statusBlock: () => MetaGroupStatusBlock;
+    /** Called after the Info or Members changed, telling which by the `namespace` of the change */
+    public onChange: BaseConfigWrapper['onChange'];
+    /** Persists the single dump returned by `dump` */
+    public autoPersist: BaseConfigWrapper['autoPersist'];
+    public flushPersist: BaseConfigWrapper['flushPersist'];
+
+    // info
+    public infoGet: () => GroupInfoGet;
+    public infoSet: (info: GroupInfoSet) => void;
+    public infoDestroy: () => void;
+
+    // members
+    public memberGet: (pubkeyHex: string) => GroupMemberGet | null;
+    public memberGetAll: () => Array<GroupMemberGet>;
+    /** Adds the members which are not in the group yet and updates the others */
+    public membersAdd: (members: Array<GroupMemberAdd>) => void;
+    /** Throws, changing nothing, if any of them is not a member */
+    public membersSetInvited: (pubkeysHex: Array<string>, failed: boolean) => void;
+    public membersSetAccepted: (pubkeysHex: Array<string>) => void;
+    public membersSetPromoted: (pubkeysHex: Array<string>, failed: boolean) => void;
+    /** Returns how many were removed. An admin rekeys the group once for the whole batch. */
+    public membersRemove: (pubkeysHex: Array<string>) => number;
+
+    // keys
+    public keysAdmin: () => boolean;
+    /**
+     * Set when several admins rekeyed concurrently: one of them must then call `keysRekey`. This is not done
+     * automatically by `merge`.
+     */
+    public keysNeedsRekey: () => boolean;
+    /** Admins only */
+    public keysRekey: () => void;
+  }
+}
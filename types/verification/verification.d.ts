@@ -0,0 +1,31 @@
+/// <reference path="../../shared.d.ts" />
+
+declare module 'libsession_util_nodejs' {
+  export type SignatureToVerify = {
+    /**
+     * The ed25519 pubkey of the signer: either 32 bytes, or hex (64 chars, or 66 chars with a 00/07/15/25 prefix).
+     * Blinded ids can be given as is. Any other prefix (such as the 05 of an x25519 session id) throws.
+     */
+    pubkey: Uint8Array | string;
+    message: Uint8Array;
+    /** len 64 */
+    signature: Uint8Array;
+  };
+
+  /**
+   * A bitmap where bit `i % 8` of byte `Math.floor(i / 8)` is set if the signature at index `i` is valid.
+   */
+  export type VerificationBitmap = Uint8Array;
+
+  /**
+   * To be used inside the web worker only
+   */
+  export class VerificationWrapperNode {
+    /** Verifies all the signatures across threads, blocking until done */
+    public static verifyMany: (toVerify: Array<SignatureToVerify>) => VerificationBitmap;
+    /** Same as `verifyMany` but the verification happens off the calling thread */
+    public static verifyManyAsync: (
+      toVerify: Array<SignatureToVerify>
+    ) => Promise<VerificationBitmap>;
+  }
+}
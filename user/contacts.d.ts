@@ -11,7 +11,21 @@ declare module 'libsession_util_nodejs' {
     get: (pubkeyHex: string) => ContactInfo | null;
     set: (contact: ContactInfoSet) => void;
     getAll: () => Array<ContactInfo>;
+    /**
+     * Case-insensitive substring search over the name and nickname of each contact.
+     * Contacts whose name or nickname starts with `query` come first.
+     * @param limit max number of contacts to return, 0 for no limit
+     */
+    search: (query: string, limit: number) => Array<ContactInfo>;
+    query: QueryFunction<ContactInfo>;
     erase: (pubkeyHex: string) => void;
+    /**
+     * Exports an immutable copy of the contacts. Its `handle()` can be posted to worker threads, which open the same copy
+     * with `new ContactsReadOnlyNode(handle)`. The copy is freed once every object reading it was garbage collected, so
+     * keep the returned object alive until the workers opened it.
+     * Every call copies all the contacts, so it costs O(number of contacts): export again only once they changed.
+     */
+    exportReadOnly: () => ContactsReadOnlyNode;
   };
 
   export type ContactsWrapperActionsCalls = MakeWrapperActionCalls<ContactsWrapper>;
@@ -52,7 +66,21 @@ declare module 'libsession_util_nodejs' {
     public get: ContactsWrapper['get'];
     public set: ContactsWrapper['set'];
     public getAll: ContactsWrapper['getAll'];
+    public search: ContactsWrapper['search'];
+    public query: ContactsWrapper['query'];
     public erase: ContactsWrapper['erase'];
+    public exportReadOnly: ContactsWrapper['exportReadOnly'];
+  }
+
+  /**
+   * Read-only contacts exported with `exportReadOnly`, usable from any worker thread.
+   */
+  export class ContactsReadOnlyNode {
+    /** Throws if every object reading that copy was already garbage collected. */
+    constructor(handle: number);
+    public get: ContactsWrapper['get'];
+    public getAll: ContactsWrapper['getAll'];
+    public handle: () => number;
   }
 
   export type ContactsConfigActionsType =
@@ -61,5 +89,7 @@ declare module 'libsession_util_nodejs' {
     | MakeActionCall<ContactsWrapper, 'get'>
     | MakeActionCall<ContactsWrapper, 'set'>
     | MakeActionCall<ContactsWrapper, 'getAll'>
+    | MakeActionCall<ContactsWrapper, 'search'>
+    | MakeActionCall<ContactsWrapper, 'query'>
     | MakeActionCall<ContactsWrapper, 'erase'>;
 }
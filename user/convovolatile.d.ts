@@ -20,20 +20,31 @@ declare module 'libsession_util_nodejs' {
     // 1o1 related methods
     get1o1: (pubkeyHex: string) => ConvoInfoVolatile1o1 | null;
     getAll1o1: () => Array<ConvoInfoVolatile1o1>;
+    query1o1: QueryFunction<ConvoInfoVolatile1o1>;
     set1o1: (pubkeyHex: string, lastRead: number, unread: boolean) => void;
     erase1o1: (pubkeyHex: string) => void;
 
     // legacy group related methods
     getLegacyGroup: (pubkeyHex: string) => ConvoInfoVolatileLegacyGroup | null;
     getAllLegacyGroups: () => Array<ConvoInfoVolatileLegacyGroup>;
+    queryLegacyGroups: QueryFunction<ConvoInfoVolatileLegacyGroup>;
     setLegacyGroup: (pubkeyHex: string, lastRead: number, unread: boolean) => void;
     eraseLegacyGroup: (pubkeyHex: string) => boolean;
 
     // communities related methods
     getCommunity: (communityFullUrl: string) => ConvoInfoVolatileCommunity | null; // pubkey not required
     getAllCommunities: () => Array<ConvoInfoVolatileCommunity>;
+    queryCommunities: QueryFunction<ConvoInfoVolatileCommunity & { pubkeyHex: string }>;
     setCommunityByFullUrl: (fullUrlWithPubkey: string, lastRead: number, unread: boolean) => void;
     eraseCommunityByFullUrl: (fullUrlWithOrWithoutPubkey: string) => void;
+
+    /**
+     * Exports an immutable copy of the conversations info. Its `handle()` can be posted to worker threads, which open the
+     * same copy with `new ConvoInfoVolatileReadOnlyNode(handle)`. The copy is freed once every object reading it was
+     * garbage collected, so keep the returned object alive until the workers opened it.
+     * Every call copies all the conversations, so it costs O(number of conversations): export again only once they changed.
+     */
+    exportReadOnly: () => ConvoInfoVolatileReadOnlyNode;
   };
 
   export type ConvoInfoVolatileWrapperActionsCalls =
@@ -44,12 +55,14 @@ declare module 'libsession_util_nodejs' {
     // 1o1 related methods
     public get1o1: ConvoInfoVolatileWrapper['get1o1'];
     public getAll1o1: ConvoInfoVolatileWrapper['getAll1o1'];
+    public query1o1: ConvoInfoVolatileWrapper['query1o1'];
     public set1o1: ConvoInfoVolatileWrapper['set1o1'];
     public erase1o1: ConvoInfoVolatileWrapper['eraseLegacyGroup'];
 
     // legacy-groups related methods
     public getLegacyGroup: ConvoInfoVolatileWrapper['getLegacyGroup'];
     public getAllLegacyGroups: ConvoInfoVolatileWrapper['getAllLegacyGroups'];
+    public queryLegacyGroups: ConvoInfoVolatileWrapper['queryLegacyGroups'];
     public setLegacyGroup: ConvoInfoVolatileWrapper['setLegacyGroup'];
     public eraseLegacyGroup: ConvoInfoVolatileWrapper['eraseLegacyGroup'];
 
@@ -57,7 +70,25 @@ declare module 'libsession_util_nodejs' {
     public getCommunity: ConvoInfoVolatileWrapper['getCommunity'];
     public setCommunityByFullUrl: ConvoInfoVolatileWrapper['setCommunityByFullUrl'];
     public getAllCommunities: ConvoInfoVolatileWrapper['getAllCommunities'];
+    public queryCommunities: ConvoInfoVolatileWrapper['queryCommunities'];
     public eraseCommunityByFullUrl: ConvoInfoVolatileWrapper['eraseCommunityByFullUrl'];
+
+    public exportReadOnly: ConvoInfoVolatileWrapper['exportReadOnly'];
+  }
+
+  /**
+   * Read-only conversations info exported with `exportReadOnly`, usable from any worker thread.
+   */
+  export class ConvoInfoVolatileReadOnlyNode {
+    /** Throws if every object reading that copy was already garbage collected. */
+    constructor(handle: number);
+    public get1o1: ConvoInfoVolatileWrapper['get1o1'];
+    public getAll1o1: ConvoInfoVolatileWrapper['getAll1o1'];
+    public getLegacyGroup: ConvoInfoVolatileWrapper['getLegacyGroup'];
+    public getAllLegacyGroups: ConvoInfoVolatileWrapper['getAllLegacyGroups'];
+    public getCommunity: ConvoInfoVolatileWrapper['getCommunity'];
+    public getAllCommunities: ConvoInfoVolatileWrapper['getAllCommunities'];
+    public handle: () => number;
   }
 
   export type ConvoInfoVolatileConfigActionsType =
@@ -65,14 +96,17 @@ declare module 'libsession_util_nodejs' {
     | MakeActionCall<ConvoInfoVolatileWrapper, 'free'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'get1o1'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'getAll1o1'>
+    | MakeActionCall<ConvoInfoVolatileWrapper, 'query1o1'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'set1o1'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'erase1o1'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'getLegacyGroup'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'getAllLegacyGroups'>
+    | MakeActionCall<ConvoInfoVolatileWrapper, 'queryLegacyGroups'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'setLegacyGroup'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'eraseLegacyGroup'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'getCommunity'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'setCommunityByFullUrl'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'getAllCommunities'>
+    | MakeActionCall<ConvoInfoVolatileWrapper, 'queryCommunities'>
     | MakeActionCall<ConvoInfoVolatileWrapper, 'eraseCommunityByFullUrl'>;
 }
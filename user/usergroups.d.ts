@@ -50,6 +50,7 @@ declare module 'libsession_util_nodejs' {
      */
     setCommunityByFullUrl: (fullUrlWithPubkey: string, priority: number) => null;
     getAllCommunities: () => Array<CommunityInfo>;
+    queryCommunities: QueryFunction<CommunityInfo>;
 
     /**
      * Note: can have the pubkey argument set or not.
@@ -60,8 +61,18 @@ declare module 'libsession_util_nodejs' {
     // Legacy groups related methods
     getLegacyGroup: (pubkeyHex: string) => LegacyGroupInfo | null;
     getAllLegacyGroups: () => Array<LegacyGroupInfo>;
+    queryLegacyGroups: QueryFunction<LegacyGroupInfo>;
     setLegacyGroup: (info: LegacyGroupInfo) => boolean;
     eraseLegacyGroup: (pubkeyHex: string) => boolean;
+
+    /**
+     * Exports an immutable copy of the communities and legacy groups. Its `handle()` can be posted to worker threads,
+     * which open the same copy with `new UserGroupsReadOnlyNode(handle)`. The copy is freed once every object reading it
+     * was garbage collected, so keep the returned object alive until the workers opened it.
+     * Every call copies all the communities and legacy groups, so it costs O(number of them): export again only once they
+     * changed.
+     */
+    exportReadOnly: () => UserGroupsReadOnlyNode;
   };
 
   export type UserGroupsWrapperActionsCalls = MakeWrapperActionCalls<UserGroupsWrapper>;
@@ -72,14 +83,31 @@ declare module 'libsession_util_nodejs' {
     public getCommunityByFullUrl: UserGroupsWrapper['getCommunityByFullUrl'];
     public setCommunityByFullUrl: UserGroupsWrapper['setCommunityByFullUrl'];
     public getAllCommunities: UserGroupsWrapper['getAllCommunities'];
+    public queryCommunities: UserGroupsWrapper['queryCommunities'];
     public eraseCommunityByFullUrl: UserGroupsWrapper['eraseCommunityByFullUrl'];
     public buildFullUrlFromDetails: UserGroupsWrapper['buildFullUrlFromDetails'];
 
     // legacy-groups related methods
     public getLegacyGroup: UserGroupsWrapper['getLegacyGroup'];
     public getAllLegacyGroups: UserGroupsWrapper['getAllLegacyGroups'];
+    public queryLegacyGroups: UserGroupsWrapper['queryLegacyGroups'];
     public setLegacyGroup: UserGroupsWrapper['setLegacyGroup'];
     public eraseLegacyGroup: UserGroupsWrapper['eraseLegacyGroup'];
+
+    public exportReadOnly: UserGroupsWrapper['exportReadOnly'];
+  }
+
+  /**
+   * Read-only communities and legacy groups exported with `exportReadOnly`, usable from any worker thread.
+   */
+  export class UserGroupsReadOnlyNode {
+    /** Throws if every object reading that copy was already garbage collected. */
+    constructor(handle: number);
+    public getCommunityByFullUrl: UserGroupsWrapper['getCommunityByFullUrl'];
+    public getAllCommunities: UserGroupsWrapper['getAllCommunities'];
+    public getLegacyGroup: UserGroupsWrapper['getLegacyGroup'];
+    public getAllLegacyGroups: UserGroupsWrapper['getAllLegacyGroups'];
+    public handle: () => number;
   }
 
   export type UserGroupsConfigActionsType =
@@ -88,9 +116,11 @@ declare module 'libsession_util_nodejs' {
     | MakeActionCall<UserGroupsWrapper, 'getCommunityByFullUrl'>
     | MakeActionCall<UserGroupsWrapper, 'setCommunityByFullUrl'>
     | MakeActionCall<UserGroupsWrapper, 'getAllCommunities'>
+    | MakeActionCall<UserGroupsWrapper, 'queryCommunities'>
     | MakeActionCall<UserGroupsWrapper, 'eraseCommunityByFullUrl'>
     | MakeActionCall<UserGroupsWrapper, 'buildFullUrlFromDetails'>
     | MakeActionCall<UserGroupsWrapper, 'getAllLegacyGroups'>
+    | MakeActionCall<UserGroupsWrapper, 'queryLegacyGroups'>
     | MakeActionCall<UserGroupsWrapper, 'getLegacyGroup'>
     | MakeActionCall<UserGroupsWrapper, 'setLegacyGroup'>
     | MakeActionCall<UserGroupsWrapper, 'eraseLegacyGroup'>;